@@ -8,9 +8,9 @@
 #include <xutil/mem.h>
 #include <xutil/log.h>
 #include <xutil/endian.h>
-#include "coroutine.h"
+#include <xe/task.h>
 
-static task run(xe_loop& loop){
+static xe_task<> run(xe_loop& loop){
 	const uint buffer_length = 16384;
 
 	byte* buf = xe_alloc<byte>(buffer_length);
@@ -52,7 +52,7 @@ int main(){
 	/* init */
 	loop.init(8); /* 8 sqes and cqes */
 
-	run(loop);
+	run(loop).start();
 
 	loop.run();
 
@@ -9,7 +9,7 @@
 #include <xutil/mem.h>
 #include <xutil/log.h>
 #include <xutil/endian.h>
-#include "coroutine.h"
+#include <xe/task.h>
 
 static ulong last_time, recvs = 0, sends = 0, clients = 0;
 
@@ -25,7 +25,7 @@ static int timer_callback(xe_loop& loop, xe_timer& timer){
 	return 0;
 }
 
-static task echo(xe_loop& loop, int fd){
+static xe_task<> echo(xe_loop& loop, int fd){
 	/* smaller buffer sizes yield greater performance due to close proximity between blocks */
 	constexpr uint buffer_length = 512;
 
@@ -55,7 +55,7 @@ static task echo(xe_loop& loop, int fd){
 	xe_print("client closed with error: %s, %lu still open", xe_strerror(result), --clients);
 }
 
-static task start_server(xe_loop& loop){
+static xe_task<> start_server(xe_loop& loop){
 	/* listen addr */
 	sockaddr_in addr;
 	int yes = 1;
@@ -89,7 +89,7 @@ static task start_server(xe_loop& loop){
 		if(client < 0)
 			break;
 		setsockopt(client, SOL_SOCKET, TCP_NODELAY, &yes, sizeof(yes));
-		echo(loop, client);
+		echo(loop, client).start();
 		xe_print("accepted a client. %lu clients open", ++clients);
 	}
 
@@ -115,7 +115,7 @@ int main(){
 	xe_print("initialized with %u sqes and %u cqes", loop.sqe_count(), loop.cqe_count());
 
 	/* start */
-	start_server(loop);
+	start_server(loop).start();
 
 	/* stats */
 	timer.callback = timer_callback;
@@ -1,9 +1,9 @@
 #include <unistd.h>
 #include <xe/loop.h>
 #include <xe/io/file.h>
-#include "coroutine.h"
+#include <xe/task.h>
 
-static task run(xe_loop& loop){
+static xe_task<> run(xe_loop& loop){
 	xe_file file(loop);
 	byte data[16384];
 	long offset = 0;
@@ -30,7 +30,7 @@ int main(){
 	/* init */
 	loop.init(8);
 
-	run(loop);
+	run(loop).start();
 
 	loop.run();
 
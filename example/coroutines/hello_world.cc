@@ -2,7 +2,7 @@
 #include <xe/loop.h>
 #include <xe/error.h>
 #include <xutil/log.h>
-#include "coroutine.h"
+#include <xe/task.h>
 
 static void handle_error(xe_cstr where, int error){
 	if(error < 0){
@@ -11,7 +11,7 @@ static void handle_error(xe_cstr where, int error){
 	}
 }
 
-static task run(xe_loop& loop){
+static xe_task<> run(xe_loop& loop){
 	char msg[] = "Hello World!\n";
 
 	co_await loop.run(xe_op::write(STDOUT_FILENO, msg, sizeof(msg) - 1, 0));
@@ -26,7 +26,7 @@ int main(){
 
 	handle_error("init", err);
 
-	run(loop);
+	run(loop).start();
 
 	err = loop.run();
 
@@ -5,12 +5,14 @@
 #include <xe/clock.h>
 #include <xe/error.h>
 #include <xe/io/socket.h>
+#include <xe/io/listener.h>
 #include <xutil/mem.h>
 #include <xutil/log.h>
 #include <xutil/endian.h>
 
 static ulong last_time, recvs = 0, sends = 0, clients = 0;
 static xe_socket server;
+static xe_listener listener(server);
 
 /* stats */
 static int timer_callback(xe_loop& loop, xe_timer& timer){
@@ -74,7 +76,7 @@ struct echo_client{
 		/* alloc buffer */
 		buf = xe_alloc_aligned<byte>(buffer_length, buffer_length);
 
-		xe_print("accepted a client. %lu clients open", ++clients);
+		xe_print("accepted a client on napi id %d. %lu clients open", socket.napi_id(), ++clients);
 
 		/* start recving */
 		socket.recv(recv, buf, buffer_length, 0);
@@ -85,21 +87,22 @@ struct echo_client{
 
 		xe_dealloc(buf);
 		xe_print("closing a client. %lu still open", --clients);
+
+		/* keep the listener's connection count in step */
+		listener.release();
 	}
 };
 
-static void accept_callback(xe_req& req, int result){
+static void accept_callback(xe_listener& listener, int result, int* fds){
 	if(result < 0){
 		xe_print("failed to accept: %s", xe_strerror(result));
 
 		return;
 	}
 
-	/* queue up another accept */
-	server.accept(req, null, null, 0);
-
-	/* create a client socket */
-	xe_znew<echo_client>(server.loop(), result);
+	/* create the client sockets, the accept stays armed */
+	for(int i = 0; i < result; i++)
+		xe_znew<echo_client>(server.loop(), fds[i]);
 }
 
 static void setup_socket(){
@@ -122,7 +125,7 @@ static void setup_socket(){
 	server.listen(SOMAXCONN);
 }
 
-int main(){
+int main(int argc, char** argv){
 	using namespace std::chrono_literals;
 
 	xe_loop loop;
@@ -133,6 +136,12 @@ int main(){
 	options.cq_entries = 65536;
 	options.flag_cqsize = true;
 
+	/* ./echoserver napi to busy poll the nic instead of waiting on interrupts */
+	if(argc > 1 && !strcmp(argv[1], "napi")){
+		options.napi_busy_poll_us = 50;
+		options.flag_napi_prefer_busy_poll = true;
+	}
+
 	/* init */
 	loop.init_options(options);
 
@@ -142,11 +151,9 @@ int main(){
 	setup_socket();
 
 	/* accept clients */
-	xe_req accept_req;
-
-	accept_req.callback = accept_callback;
+	listener.callback = accept_callback;
 	server.set_loop(loop);
-	server.accept(accept_req, null, null, 0);
+	listener.start();
 
 	/* accept clients */
 	last_time = xe_time_ns();
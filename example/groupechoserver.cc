@@ -0,0 +1,127 @@
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <xe/loop.h>
+#include <xe/group.h>
+#include <xe/error.h>
+#include <xe/io/socket.h>
+#include <xutil/mem.h>
+#include <xutil/log.h>
+#include <xutil/endian.h>
+
+/* one listener per thread, the kernel shards connections between them */
+static constexpr uint threads = 4;
+
+static xe_socket servers[threads];
+static xe_req accept_reqs[threads];
+
+/* client structure */
+struct echo_client{
+	static constexpr uint buffer_length = 512;
+
+	xe_socket socket;
+	xe_req recv;
+	xe_req send;
+	byte* buf;
+
+	static void recv_callback(xe_req& req, int result){
+		echo_client& client = xe_containerof(req, &echo_client::recv);
+
+		if(result > 0)
+			client.socket.send(client.send, client.buf, result, 0);
+		else
+			xe_delete(&client);
+	}
+
+	static void send_callback(xe_req& req, int result){
+		echo_client& client = xe_containerof(req, &echo_client::send);
+
+		if(result > 0)
+			client.socket.recv(client.recv, client.buf, buffer_length, 0);
+		else
+			xe_delete(&client);
+	}
+
+	echo_client(xe_loop& loop, int fd): socket(loop){
+		int yes = 1;
+
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+		socket.accept(fd);
+
+		recv.callback = recv_callback;
+		send.callback = send_callback;
+
+		buf = xe_alloc_aligned<byte>(buffer_length, buffer_length);
+
+		socket.recv(recv, buf, buffer_length, 0);
+	}
+
+	~echo_client(){
+		socket.close();
+
+		xe_dealloc(buf);
+	}
+};
+
+static void accept_callback(xe_req& req, int result){
+	xe_socket& server = servers[&req - accept_reqs];
+
+	if(result < 0){
+		xe_print("failed to accept: %s", xe_strerror(result));
+
+		return;
+	}
+
+	server.accept(req, null, null, 0);
+
+	xe_znew<echo_client>(server.loop(), result);
+}
+
+/* runs on each worker thread */
+static int start_callback(xe_loop_group& group, xe_loop& loop, uint index){
+	accept_reqs[index].callback = accept_callback;
+
+	return servers[index].accept(accept_reqs[index], null, null, 0);
+}
+
+int main(){
+	xe_loop_group group;
+	xe_loop_options options;
+	sockaddr_in addr;
+	int err;
+
+	options.entries = 256;
+	options.cq_entries = 65536;
+	options.flag_cqsize = true;
+
+	if((err = group.init(threads, options))){
+		xe_print("failed to init group: %s", xe_strerror(err));
+
+		return -1;
+	}
+
+	xe_zero(&addr);
+
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+	addr.sin_port = xe_hton<ushort>(8080);
+
+	/* steer each connection to the thread on the cpu that received it */
+	if((err = group.listen(servers, (sockaddr*)&addr, sizeof(addr), SOMAXCONN, true))){
+		xe_print("failed to listen: %s", xe_strerror(err));
+
+		return -1;
+	}
+
+	group.start_callback = start_callback;
+
+	if(!(err = group.start()))
+		err = group.join();
+	if(err)
+		xe_print("group exited: %s", xe_strerror(err));
+	for(auto& server : servers)
+		server.close();
+	group.close();
+
+	return 0;
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <netdb.h>
+#include <fcntl.h>
 #include <arpa/inet.h>
 #include <netinet/tcp.h>
 #include <xe/loop.h>
@@ -50,8 +51,11 @@ struct echo_client{
 			return;
 		}
 
-		/* we only asked for XE_POLL_IN, so we only have XE_POLL_IN (assuming we checked the err flags) */
-		do{
+		/*
+		 * we only asked for XE_POLL_IN, so we only have XE_POLL_IN (assuming we checked the err flags)
+		 * the poll is multishot and only reports new data, so read until there is none left
+		 */
+		while(true){
 			result = client.socket.recv_sync(client.buf, buffer_length, MSG_DONTWAIT);
 
 			if(result <= 0)
@@ -62,10 +66,10 @@ struct echo_client{
 			if(result < 0)
 				break;
 			sends++;
+		}
 
+		if(result == XE_EAGAIN)
 			return;
-		}while(false);
-
 		/* error */
 		client.close();
 	}
@@ -104,6 +108,7 @@ struct echo_client{
 		/* set up callbacks */
 		poll.poll_callback = poll_cb;
 		poll.close_callback = close_cb;
+		poll.set_multishot(true);
 
 		/* alloc buffer */
 		buf = xe_alloc_aligned<byte>(0, buffer_length); /* 0 = page size aligned */
@@ -132,11 +137,16 @@ static void accept_callback(xe_poll& poll, int result){
 		return;
 	}
 
-	if(result & XE_POLL_IN){
+	if(!(result & XE_POLL_IN))
+		return;
+	/* the poll is multishot, accept every pending connection */
+	while(true){
 		int client = server.accept_sync(null, null, 0);
 
+		if(client == XE_EAGAIN)
+			break;
 		if(client < 0){
-			xe_print("failed to accept: %s", xe_strerror(result));
+			xe_print("failed to accept: %s", xe_strerror(client));
 
 			poll.close();
 
@@ -166,6 +176,9 @@ static void setup_socket(){
 
 	server.bind((sockaddr*)&addr, sizeof(addr));
 	server.listen(SOMAXCONN);
+
+	/* accept until EAGAIN without blocking */
+	fcntl(server.fd(), F_SETFL, fcntl(server.fd(), F_GETFL) | O_NONBLOCK);
 }
 
 int main(){
@@ -191,6 +204,7 @@ int main(){
 	xe_poll accept_poll(loop);
 
 	accept_poll.poll_callback = accept_callback;
+	accept_poll.set_multishot(true);
 	accept_poll.set_fd(server.fd());
 	accept_poll.poll(XE_POLL_IN);
 
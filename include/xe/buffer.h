@@ -0,0 +1 @@
+#include "../../xe/buffer.h"
\ No newline at end of file
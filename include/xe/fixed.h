@@ -0,0 +1 @@
+#include "../../xe/fixed.h"
\ No newline at end of file
@@ -0,0 +1 @@
+#include "../../xe/group.h"
\ No newline at end of file
@@ -0,0 +1 @@
+#include "../../../xe/io/listener.h"
\ No newline at end of file
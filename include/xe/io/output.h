@@ -0,0 +1 @@
+#include "../../../xe/io/output.h"
\ No newline at end of file
@@ -0,0 +1 @@
+#include "../../../xe/io/reactor.h"
\ No newline at end of file
@@ -0,0 +1 @@
+#include "../../../xe/io/reader.h"
\ No newline at end of file
@@ -0,0 +1 @@
+#include "../../../xe/io/sendfile.h"
\ No newline at end of file
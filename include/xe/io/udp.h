@@ -0,0 +1 @@
+#include "../../../xe/io/udp.h"
\ No newline at end of file
@@ -0,0 +1 @@
+#include "../../xe/stats.h"
\ No newline at end of file
@@ -0,0 +1 @@
+#include "../../xe/task.h"
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "xutil/mem.h"
+#include "buffer.h"
+#include "error.h"
+
+int xe_buffer_ring::init(xe_loop& loop, ushort bgid_, uint count, uint size){
+	int err;
+
+	if(ring)
+		return XE_STATE;
+	if(!count || count > 32768 || (count & (count - 1)) || !size)
+		return XE_EINVAL;
+	ring = xe_alloc_aligned<io_uring_buf_ring>(0, count);
+	buffers = xe_alloc_aligned<byte>(0, (size_t)count * size);
+
+	if(!ring || !buffers){
+		err = XE_ENOMEM;
+
+		goto err;
+	}
+
+	io_uring_buf_ring_init(ring);
+
+	loop_ = &loop;
+	count_ = count;
+	size_ = size;
+	mask = io_uring_buf_ring_mask(count);
+	bgid = bgid_;
+
+	err = loop.register_buf_ring(ring, count, bgid);
+
+	if(err)
+		goto err;
+	for(uint i = 0; i < count; i++)
+		io_uring_buf_ring_add(ring, buffer(i), size, i, mask, i);
+	io_uring_buf_ring_advance(ring, count);
+
+	available_ = count;
+
+	return 0;
+err:
+	xe_deallocp((xe_ptr&)ring);
+	xe_deallocp((xe_ptr&)buffers);
+
+	return err;
+}
+
+void xe_buffer_ring::wake(){
+	xe_buffer_waiter* waiter;
+
+	while(waiters && available_){
+		waiter = &waiters.front();
+		waiters.erase(*waiter);
+		waiter -> callback(*waiter);
+	}
+}
+
+void xe_buffer_ring::close(){
+	if(!ring)
+		return;
+	while(waiters)
+		waiters.erase(waiters.front());
+	loop_ -> unregister_buf_ring(bgid);
+
+	xe_deallocp((xe_ptr&)ring);
+	xe_deallocp((xe_ptr&)buffers);
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+#include "xstd/types.h"
+#include "xstd/linked_list.h"
+#include "xutil/util.h"
+#include "loop.h"
+
+class xe_buffer_waiter : protected xe_linked_node{
+private:
+	friend class xe_buffer_ring;
+public:
+	void (*callback)(xe_buffer_waiter& waiter);
+
+	xe_buffer_waiter(){
+		callback = null;
+	}
+
+	xe_disable_copy_move(xe_buffer_waiter)
+
+	bool waiting() const{
+		return linked();
+	}
+
+	void cancel(){
+		if(linked()) erase();
+	}
+
+	~xe_buffer_waiter() = default;
+};
+
+/*
+ * kernel provided buffers (IORING_REGISTER_PBUF_RING)
+ * ops started with buffer_select(id()) pick a buffer from the ring
+ * on completion, and the buffer is given back with a tail bump
+ */
+class xe_buffer_ring{
+private:
+	void wake();
+
+	xe_loop* loop_;
+	io_uring_buf_ring* ring;
+	byte* buffers;
+
+	xe_linked_list<xe_buffer_waiter> waiters;
+
+	uint count_;
+	uint available_;
+	uint size_;
+	ushort mask;
+	ushort bgid;
+public:
+	xe_buffer_ring(){
+		loop_ = null;
+		ring = null;
+		buffers = null;
+
+		count_ = 0;
+		available_ = 0;
+		size_ = 0;
+		mask = 0;
+		bgid = 0;
+	}
+
+	xe_disable_copy_move(xe_buffer_ring)
+
+	/* count must be a power of two, at most 32768 */
+	int init(xe_loop& loop, ushort bgid, uint count, uint size);
+	void close();
+
+	xe_loop& loop() const{
+		return *loop_;
+	}
+
+	/* buffer group id to pass to buffer_select */
+	ushort id() const{
+		return bgid;
+	}
+
+	uint count() const{
+		return count_;
+	}
+
+	uint buffer_size() const{
+		return size_;
+	}
+
+	/* buffers currently owned by the kernel */
+	uint available() const{
+		return available_;
+	}
+
+	xe_ptr buffer(ushort bid) const{
+		return buffers + (size_t)bid * size_;
+	}
+
+	/* claim a buffer the kernel handed out in a completion */
+	xe_ptr take(ushort bid){
+		available_--;
+
+		return buffer(bid);
+	}
+
+	/* give a buffer back to the kernel */
+	void recycle(ushort bid){
+		io_uring_buf_ring_add(ring, buffer(bid), size_, bid, mask, 0);
+		io_uring_buf_ring_advance(ring, 1);
+
+		available_++;
+
+		if(waiters) [[unlikely]]
+			wake();
+	}
+
+	void recycle(xe_cptr buf){
+		recycle((ushort)(((const byte*)buf - buffers) / size_));
+	}
+
+	/* call back once a buffer is recycled */
+	void wait(xe_buffer_waiter& waiter){
+		waiters.append(waiter);
+	}
+
+	static bool has_buffer(uint cqe_flags){
+		return cqe_flags & IORING_CQE_F_BUFFER;
+	}
+
+	static ushort buffer_id(uint cqe_flags){
+		return cqe_flags >> IORING_CQE_BUFFER_SHIFT;
+	}
+
+	~xe_buffer_ring() = default;
+};
\ No newline at end of file
@@ -1,6 +1,15 @@
 #include <time.h>
+#include <atomic>
+#include "xstd/std.h"
 #include "clock.h"
 
+#if defined __x86_64__ || defined __i386__
+	#include <cpuid.h>
+	#include <x86intrin.h>
+
+	#define XE_TSC 1
+#endif
+
 static ulong xe_nstime(clockid_t clock){
 	timespec time;
 
@@ -31,4 +40,146 @@ ulong xe_realtime_ns(){
 
 ulong xe_realtime_ms(){
 	return xe_mstime(CLOCK_REALTIME);
-}
\ No newline at end of file
+}
+
+#ifdef XE_TSC
+enum{
+	XE_TSC_SHIFT = 32,
+	XE_TSC_SETUP_NS = 10 * XE_NANOS_PER_MS,
+	XE_TSC_CALIBRATE_NS = XE_NANOS_PER_SEC,
+	XE_TSC_SLEW_SHIFT = 4 /* correct by at most 1/16th of the rate */
+};
+
+/* ns = base_ns + ((tsc - base_tsc) * mult) >> XE_TSC_SHIFT, guarded by a seqlock */
+static std::atomic<uint> xe_tsc_seq;
+static std::atomic<bool> xe_tsc_writer;
+static std::atomic<bool> xe_tsc_enabled;
+static std::atomic<ulong> xe_tsc_base;
+static std::atomic<ulong> xe_tsc_base_ns;
+static std::atomic<ulong> xe_tsc_mult;
+
+/* the last calibration point, only touched by the writer */
+static ulong xe_tsc_anchor;
+static ulong xe_tsc_anchor_ns;
+
+static inline ulong xe_tsc_scale(ulong ticks, ulong mult){
+	return ((unsigned __int128)ticks * mult) >> XE_TSC_SHIFT;
+}
+
+static inline ulong xe_tsc_rate(ulong ticks, ulong ns){
+	return ((unsigned __int128)ns << XE_TSC_SHIFT) / ticks;
+}
+
+/* the change in mult that moves the clock by offset ns over one calibration period */
+static inline ulong xe_tsc_slew(ulong mult, ulong offset){
+	return ((unsigned __int128)mult * offset) / XE_TSC_CALIBRATE_NS;
+}
+
+static void xe_tsc_store(ulong base, ulong base_ns, ulong mult){
+	xe_tsc_seq.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	xe_tsc_base.store(base, std::memory_order_relaxed);
+	xe_tsc_base_ns.store(base_ns, std::memory_order_relaxed);
+	xe_tsc_mult.store(mult, std::memory_order_relaxed);
+
+	xe_tsc_seq.fetch_add(1, std::memory_order_release);
+}
+
+static bool xe_tsc_setup(){
+	uint eax, ebx, ecx, edx;
+	ulong tsc, ns;
+	timespec wait;
+
+	/* the tsc must tick at a constant rate through frequency and power state changes */
+	if(!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1 << 8)))
+		return false;
+	wait.tv_sec = 0;
+	wait.tv_nsec = XE_TSC_SETUP_NS;
+
+	xe_tsc_anchor_ns = xe_time_ns();
+	xe_tsc_anchor = __rdtsc();
+
+	nanosleep(&wait, null);
+
+	ns = xe_time_ns();
+	tsc = __rdtsc();
+
+	if(tsc <= xe_tsc_anchor)
+		return false;
+	xe_tsc_store(tsc, ns, xe_tsc_rate(tsc - xe_tsc_anchor, ns - xe_tsc_anchor_ns));
+	xe_tsc_anchor = tsc;
+	xe_tsc_anchor_ns = ns;
+	xe_tsc_enabled.store(true, std::memory_order_release);
+
+	return true;
+}
+
+bool xe_tsc_init(){
+	static bool supported = xe_tsc_setup();
+
+	return supported;
+}
+
+void xe_tsc_calibrate(){
+	ulong tsc, ns, now, mult, limit;
+
+	if(!xe_tsc_enabled.load(std::memory_order_acquire) || xe_tsc_writer.exchange(true, std::memory_order_acquire))
+		return;
+	ns = xe_time_ns();
+	tsc = __rdtsc();
+
+	if(ns - xe_tsc_anchor_ns >= XE_TSC_CALIBRATE_NS && tsc > xe_tsc_anchor){
+		now = xe_tsc_base_ns.load(std::memory_order_relaxed) +
+			xe_tsc_scale(tsc - xe_tsc_base.load(std::memory_order_relaxed), xe_tsc_mult.load(std::memory_order_relaxed));
+		mult = xe_tsc_rate(tsc - xe_tsc_anchor, ns - xe_tsc_anchor_ns);
+		limit = mult >> XE_TSC_SLEW_SHIFT;
+
+		/*
+		 * continue from the current reading so time never goes backwards,
+		 * and tick slower or faster than the measured rate to meet CLOCK_MONOTONIC by the next calibration
+		 */
+		if(now > ns)
+			mult -= xe_min(xe_tsc_slew(mult, now - ns), limit);
+		else if(ns - now > XE_TSC_CALIBRATE_NS >> XE_TSC_SLEW_SHIFT)
+			now = ns; /* too far behind to slew, step forward */
+		else
+			mult += xe_min(xe_tsc_slew(mult, ns - now), limit);
+		xe_tsc_store(tsc, now, mult);
+		xe_tsc_anchor = tsc;
+		xe_tsc_anchor_ns = ns;
+	}
+
+	xe_tsc_writer.store(false, std::memory_order_release);
+}
+
+ulong xe_tsc_ns(){
+	ulong tsc, base, base_ns, mult;
+	uint seq;
+
+	if(!xe_tsc_enabled.load(std::memory_order_relaxed)) [[unlikely]]
+		return xe_time_ns();
+	do{
+		seq = xe_tsc_seq.load(std::memory_order_acquire);
+		base = xe_tsc_base.load(std::memory_order_relaxed);
+		base_ns = xe_tsc_base_ns.load(std::memory_order_relaxed);
+		mult = xe_tsc_mult.load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}while((seq & 1) || seq != xe_tsc_seq.load(std::memory_order_relaxed));
+
+	tsc = __rdtsc();
+
+	return base_ns + xe_tsc_scale(tsc > base ? tsc - base : 0, mult);
+}
+#else
+bool xe_tsc_init(){
+	return false;
+}
+
+void xe_tsc_calibrate(){}
+
+ulong xe_tsc_ns(){
+	return xe_time_ns();
+}
+#endif
\ No newline at end of file
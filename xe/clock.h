@@ -13,4 +13,12 @@ enum xe_time_constants{
 ulong xe_time_ns(); /* system time in nanoseconds */
 ulong xe_time_ms(); /* system time in milliseconds */
 ulong xe_realtime_ns(); /* time since epoch in nanoseconds */
-ulong xe_realtime_ms(); /* time since epoch in milliseconds */
\ No newline at end of file
+ulong xe_realtime_ms(); /* time since epoch in milliseconds */
+
+/*
+ * invariant tsc clock, calibrated against CLOCK_MONOTONIC
+ * xe_tsc_ns falls back to xe_time_ns when there is no usable tsc
+ */
+bool xe_tsc_init(); /* false if the cpu has no invariant tsc */
+void xe_tsc_calibrate(); /* correct drift, at most once per second across all threads */
+ulong xe_tsc_ns();
\ No newline at end of file
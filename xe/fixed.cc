@@ -0,0 +1,131 @@
+#include <sys/uio.h>
+#include "xutil/mem.h"
+#include "xutil/assert.h"
+#include "fixed.h"
+#include "loop.h"
+#include "error.h"
+
+int xe_fixed_buffers::init(xe_loop& loop, uint count){
+	iovec iovecs[CLASSES];
+	xe_buffer* buffer;
+	size_t total = 0;
+	size_t size;
+	int err;
+
+	if(memory)
+		return XE_STATE;
+	if(!count || count > MAX_COUNT)
+		return XE_EINVAL;
+	for(uint i = 0; i < CLASSES; i++)
+		total += class_size(i) * count;
+	memory = xe_alloc_aligned<byte>(0, total);
+
+	if(!memory)
+		return XE_ENOMEM;
+	used = xe_zalloc<ulong>((CLASSES * count + 63) / 64);
+
+	if(!used){
+		close();
+
+		return XE_ENOMEM;
+	}
+
+	regions[0] = memory;
+
+	for(uint i = 0; i < CLASSES; i++){
+		size = class_size(i);
+		regions[i + 1] = regions[i] + size * count;
+		iovecs[i].iov_base = regions[i];
+		iovecs[i].iov_len = size * count;
+
+		/* push in reverse so buffers are handed out in address order */
+		for(uint j = count; j > 0; j--){
+			buffer = (xe_buffer*)(regions[i] + size * (j - 1));
+			buffer -> next = buffers[i];
+			buffers[i] = buffer;
+		}
+
+		available_[i] = count;
+	}
+
+	err = loop.register_buffers(iovecs, CLASSES);
+
+	if(err){
+		close();
+
+		return err;
+	}
+
+	count_ = count;
+
+	return 0;
+}
+
+void xe_fixed_buffers::close(){
+	if(!memory)
+		return;
+	/* the registration goes away with the ring */
+	xe_deallocp((xe_ptr&)memory);
+	xe_deallocp((xe_ptr&)used);
+
+	for(uint i = 0; i < CLASSES; i++){
+		regions[i] = null;
+		buffers[i] = null;
+		available_[i] = 0;
+	}
+
+	regions[CLASSES] = null;
+	count_ = 0;
+}
+
+xe_ptr xe_fixed_buffers::acquire(size_t size){
+	xe_buffer* buffer;
+	uint size_class;
+	size_t i;
+
+	if(size > class_size(CLASSES - 1))
+		return null;
+	size_class = size <= 1ul << MIN_SHIFT ? 0 : (64 - __builtin_clzl(size - 1) - MIN_SHIFT + CLASS_SHIFT - 1) / CLASS_SHIFT;
+
+	/* fall back to a larger class when this one is empty */
+	for(; size_class < CLASSES; size_class++){
+		buffer = buffers[size_class];
+
+		if(!buffer)
+			continue;
+		buffers[size_class] = buffer -> next;
+		available_[size_class]--;
+		i = slot(size_class, (byte*)buffer);
+		used[i / 64] |= 1ul << (i % 64);
+
+		return buffer;
+	}
+
+	return null;
+}
+
+void xe_fixed_buffers::release(xe_ptr buf){
+	xe_buffer* buffer = (xe_buffer*)buf;
+	int size_class = index(buf, 1);
+	size_t offset, i;
+	ulong bit;
+
+	xe_assertm(size_class >= 0, "not a fixed buffer");
+
+	if(size_class < 0)
+		return;
+	offset = (byte*)buf - regions[size_class];
+	i = slot(size_class, (byte*)buf);
+	bit = 1ul << (i % 64);
+
+	xe_assertm(!(offset & (class_size(size_class) - 1)), "not the start of a buffer");
+	xe_assertm(used[i / 64] & bit, "buffer released twice");
+
+	/* a bad release would corrupt the free list, drop it */
+	if((offset & (class_size(size_class) - 1)) || !(used[i / 64] & bit))
+		return;
+	used[i / 64] &= ~bit;
+	buffer -> next = buffers[size_class];
+	buffers[size_class] = buffer;
+	available_[size_class]++;
+}
\ No newline at end of file
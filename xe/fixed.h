@@ -0,0 +1,91 @@
+#pragma once
+#include "xstd/types.h"
+#include "xutil/util.h"
+
+class xe_loop;
+
+/*
+ * registered buffers in size classes of 4K, 16K, 64K and 256K
+ * each class is one registered buffer, so any range inside it
+ * can be used with read_fixed and write_fixed without pinning pages per op
+ */
+class xe_fixed_buffers{
+private:
+	enum{
+		MIN_SHIFT = 12, /* 4096 bytes */
+		CLASS_SHIFT = 2,
+		CLASSES = 4, /* up to 256K */
+		MAX_COUNT = 4096 /* keeps the largest class under the kernel's 1G limit */
+	};
+
+	struct xe_buffer{
+		xe_buffer* next;
+	};
+
+	byte* memory;
+	byte* regions[CLASSES + 1];
+	xe_buffer* buffers[CLASSES];
+	ulong* used; /* a bit per buffer, set while acquired */
+
+	uint count_;
+	uint available_[CLASSES];
+
+	size_t slot(uint size_class, const byte* ptr) const{
+		return size_class * count_ + (size_t)(ptr - regions[size_class]) / class_size(size_class);
+	}
+public:
+	xe_fixed_buffers(){
+		memory = null;
+		used = null;
+
+		for(uint i = 0; i < CLASSES; i++){
+			regions[i] = null;
+			buffers[i] = null;
+			available_[i] = 0;
+		}
+
+		regions[CLASSES] = null;
+		count_ = 0;
+	}
+
+	xe_disable_copy_move(xe_fixed_buffers)
+
+	/* count buffers of each size class, registered as the loop's fixed buffer table */
+	int init(xe_loop& loop, uint count);
+	void close();
+
+	static size_t class_size(uint size_class){
+		return (size_t)1 << (MIN_SHIFT + size_class * CLASS_SHIFT);
+	}
+
+	/* buffers of each size class */
+	uint count() const{
+		return count_;
+	}
+
+	uint available(uint size_class) const{
+		return available_[size_class];
+	}
+
+	/* a buffer of at least size bytes, or null if none is free */
+	xe_ptr acquire(size_t size);
+	void release(xe_ptr buf);
+
+	/* the registered buffer index to pass to the _fixed ops, -1 if the range is not in a buffer */
+	int index(xe_cptr buf, size_t len) const{
+		const byte* ptr = (const byte*)buf;
+
+		if(ptr < memory || ptr >= regions[CLASSES])
+			return -1;
+		for(uint i = 1; i <= CLASSES; i++){
+			if(ptr < regions[i])
+				return (size_t)(regions[i] - ptr) >= len ? i - 1 : -1;
+		}
+
+		return -1;
+	}
+
+	~xe_fixed_buffers(){
+		close();
+	}
+};
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "xutil/mem.h"
+#include "frame.h"
+
+thread_local xe_frame_pool* xe_frame_pool::current_ = null;
+
+xe_ptr xe_frame_pool::alloc(size_t size){
+	xe_frame_header* header;
+	xe_frame* frame;
+	uint size_class;
+
+	size += sizeof(xe_frame_header);
+
+	if(size > 1ul << (MIN_SHIFT + CLASSES - 1)) [[unlikely]] {
+		/* too big to cache */
+		header = (xe_frame_header*)xe_alloc<byte>(size);
+
+		if(!header)
+			return null;
+		header -> pool = null;
+		header -> size_class = 0;
+
+		return header + 1;
+	}
+
+	size_class = size <= 1ul << MIN_SHIFT ? 0 : 64 - __builtin_clzl(size - 1) - MIN_SHIFT;
+	frame = frames[size_class];
+
+	if(frame){
+		frames[size_class] = frame -> next;
+		cached[size_class]--;
+		header = (xe_frame_header*)frame;
+	}else{
+		header = (xe_frame_header*)xe_alloc<byte>(1ul << (size_class + MIN_SHIFT));
+
+		if(!header)
+			return null;
+	}
+
+	header -> pool = this;
+	header -> size_class = size_class;
+	live++;
+
+	return header + 1;
+}
+
+void xe_frame_pool::clear(){
+	xe_frame* frame;
+	xe_frame* next;
+
+	for(uint i = 0; i < CLASSES; i++){
+		frame = frames[i];
+
+		while(frame){
+			next = frame -> next;
+			xe_dealloc(frame);
+			frame = next;
+		}
+
+		frames[i] = null;
+		cached[i] = 0;
+	}
+}
+
+xe_ptr xe_frame_pool::alloc_current(size_t size){
+	xe_frame_header* header;
+
+	if(current_) [[likely]]
+		return current_ -> alloc(size);
+	header = (xe_frame_header*)xe_alloc<byte>(size + sizeof(xe_frame_header));
+
+	if(!header)
+		return null;
+	header -> pool = null;
+	header -> size_class = 0;
+
+	return header + 1;
+}
+
+void xe_frame_pool::dealloc(xe_ptr ptr){
+	xe_frame_header* header;
+	xe_frame_pool* pool;
+	xe_frame* frame;
+	uint size_class;
+
+	if(!ptr)
+		return;
+	header = (xe_frame_header*)ptr - 1;
+	pool = header -> pool;
+	size_class = header -> size_class;
+
+	if(pool)
+		pool -> live--;
+	if(!pool || pool -> cached[size_class] >= MAX_CACHED){
+		xe_dealloc(header);
+
+		return;
+	}
+
+	frame = (xe_frame*)header;
+	frame -> next = pool -> frames[size_class];
+	pool -> frames[size_class] = frame;
+	pool -> cached[size_class]++;
+}
+
+xe_frame_pool* xe_frame_pool::current(){
+	return current_;
+}
+
+void xe_frame_pool::set_current(xe_frame_pool* pool){
+	current_ = pool;
+}
\ No newline at end of file
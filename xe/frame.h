@@ -0,0 +1,59 @@
+#pragma once
+#include "xstd/types.h"
+#include "xutil/util.h"
+#include "xutil/assert.h"
+
+/*
+ * freelists of coroutine frames by size class
+ * owned by a loop, frames must be freed on the loop's thread, and before the loop is destroyed
+ */
+class xe_frame_pool{
+private:
+	enum{
+		MIN_SHIFT = 6, /* 64 bytes */
+		CLASSES = 7, /* up to 4096 bytes */
+		MAX_CACHED = 256 /* per size class */
+	};
+
+	struct xe_frame{
+		xe_frame* next;
+	};
+
+	struct alignas(16) xe_frame_header{
+		xe_frame_pool* pool; /* null if not pooled */
+		uint size_class;
+	};
+
+	static thread_local xe_frame_pool* current_;
+
+	xe_frame* frames[CLASSES];
+	uint cached[CLASSES];
+	uint live; /* handed out and not freed yet */
+public:
+	xe_frame_pool(){
+		live = 0;
+
+		for(uint i = 0; i < CLASSES; i++){
+			frames[i] = null;
+			cached[i] = 0;
+		}
+	}
+
+	xe_disable_copy_move(xe_frame_pool)
+
+	xe_ptr alloc(size_t size);
+	void clear();
+
+	/* allocate from the current thread's pool, or the heap if there is none */
+	static xe_ptr alloc_current(size_t size);
+	static void dealloc(xe_ptr ptr);
+
+	static xe_frame_pool* current();
+	static void set_current(xe_frame_pool* pool);
+
+	~xe_frame_pool(){
+		xe_assertm(!live, "coroutine frames outlive their loop");
+
+		clear();
+	}
+};
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include <linux/filter.h>
+#include "xutil/mem.h"
+#include "xutil/log.h"
+#include "io/socket.h"
+#include "group.h"
+#include "error.h"
+
+xe_ptr xe_loop_worker::main(xe_ptr arg){
+	xe_loop_worker& worker = *(xe_loop_worker*)arg;
+	xe_loop_group& group = *worker.group;
+	xe_loop_options options = group.options;
+
+	/*
+	 * io-wq workers belong to the submitting task, so attaching only shares
+	 * something when the rings use sqpoll: every loop then feeds one sq thread
+	 */
+	if(worker.index && options.flag_sqpoll){
+		options.flag_attach_wq = true;
+		options.wq_fd = group.workers[0].loop.fd();
+	}
+
+	/* the ring must be created on the thread that submits to it */
+	worker.result = worker.loop.init_options(options);
+
+	sem_post(&group.ready);
+
+	if(worker.result)
+		return null;
+	sem_wait(&group.go);
+
+	if(!group.failed){
+		if(group.start_callback)
+			worker.result = group.start_callback(group, worker.loop, worker.index);
+		if(!worker.result)
+			worker.result = worker.loop.run();
+	}
+
+	worker.loop.close();
+
+	return null;
+}
+
+int xe_loop_group::spawn(xe_loop_worker& worker){
+	pthread_attr_t attr;
+	cpu_set_t set;
+	int err;
+
+	if((err = pthread_attr_init(&attr)))
+		return xe_syserror(err);
+	if(worker.cpu >= 0){
+		CPU_ZERO(&set);
+		CPU_SET(worker.cpu, &set);
+
+		err = pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+	}
+
+	if(!err)
+		err = pthread_create(&worker.thread, &attr, xe_loop_worker::main, &worker);
+	pthread_attr_destroy(&attr);
+
+	return xe_syserror(err);
+}
+
+int xe_loop_group::init(uint count, const xe_loop_options& options_, const int* cpus){
+	if(workers)
+		return XE_STATE;
+	if(!count)
+		return XE_EINVAL;
+	workers = xe_alloc<xe_loop_worker>(count);
+
+	if(!workers)
+		return XE_ENOMEM;
+	for(uint i = 0; i < count; i++){
+		xe_construct(&workers[i]);
+
+		workers[i].group = this;
+		workers[i].index = i;
+		workers[i].cpu = cpus ? cpus[i] : i;
+		workers[i].result = 0;
+	}
+
+	sem_init(&ready, 0, 0);
+	sem_init(&go, 0, 0);
+
+	options = options_;
+	count_ = count;
+
+	return 0;
+}
+
+void xe_loop_group::close(){
+	if(!workers)
+		return;
+	for(uint i = 0; i < count_; i++)
+		xe_destruct(&workers[i]);
+	xe_deallocp((xe_ptr&)workers);
+
+	sem_destroy(&ready);
+	sem_destroy(&go);
+
+	count_ = 0;
+	started = 0;
+}
+
+int xe_loop_group::start(){
+	int err = 0;
+	uint i;
+
+	if(started)
+		return XE_EALREADY;
+	/* start one at a time, the first ring's io-wq must exist before the rest attach */
+	for(i = 0; i < count_; i++){
+		if((err = spawn(workers[i])))
+			break;
+		sem_wait(&ready);
+
+		if((err = workers[i].result)){
+			i++;
+
+			break;
+		}
+	}
+
+	started = i;
+	failed = err != 0;
+
+	for(i = 0; i < started; i++)
+		sem_post(&go);
+	if(err){
+		xe_log_error(this, "failed to start worker: %s", xe_strerror(err));
+
+		join();
+	}
+
+	return err;
+}
+
+int xe_loop_group::join(){
+	int err = 0;
+
+	for(uint i = 0; i < started; i++){
+		pthread_join(workers[i].thread, null);
+
+		if(!err) err = workers[i].result;
+	}
+
+	started = 0;
+
+	return err;
+}
+
+int xe_loop_group::listen(xe_socket* sockets, const sockaddr* addr, socklen_t addrlen, int backlog, bool steer){
+	sock_filter* code;
+	sock_fprog prog;
+	uint i, len;
+	int err, yes;
+
+	yes = 1;
+	err = 0;
+
+	/* the reuseport group index is the order the sockets start listening */
+	for(i = 0; i < count_; i++){
+		sockets[i].set_loop(workers[i].loop);
+
+		if((err = sockets[i].init_sync(addr -> sa_family, SOCK_STREAM, IPPROTO_TCP)))
+			break;
+		if(setsockopt(sockets[i].fd(), SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) < 0 ||
+			setsockopt(sockets[i].fd(), SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)) < 0){
+			err = xe_errno();
+
+			break;
+		}
+
+		if((err = sockets[i].bind((sockaddr*)addr, addrlen)) || (err = sockets[i].listen(backlog)))
+			break;
+	}
+
+	if(!err && steer){
+		/*
+		 * A = current cpu
+		 * return the index of the worker pinned to it,
+		 * or fall back to cpu % count
+		 */
+		len = count_ * 2 + 3;
+		code = xe_alloc<sock_filter>(len);
+
+		if(!code)
+			err = XE_ENOMEM;
+		else{
+			code[0] = BPF_STMT(BPF_LD | BPF_W | BPF_ABS, (uint)(SKF_AD_OFF + SKF_AD_CPU));
+
+			for(i = 0; i < count_; i++){
+				code[i * 2 + 1] = BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, (uint)workers[i].cpu, 0, 1);
+				code[i * 2 + 2] = BPF_STMT(BPF_RET | BPF_K, i);
+			}
+
+			code[len - 2] = BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, count_);
+			code[len - 1] = BPF_STMT(BPF_RET | BPF_A, 0);
+
+			prog.len = len;
+			prog.filter = code;
+
+			if(setsockopt(sockets[0].fd(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) < 0)
+				err = xe_errno();
+			xe_dealloc(code);
+		}
+	}
+
+	if(err){
+		for(i = 0; i < count_; i++)
+			sockets[i].close();
+	}
+
+	return err;
+}
+
+xe_cstr xe_loop_group::class_name(){
+	return "xe_loop_group";
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/socket.h>
+#include "xstd/types.h"
+#include "xutil/util.h"
+#include "loop.h"
+
+class xe_socket;
+class xe_loop_group;
+class xe_loop_worker{
+private:
+	static xe_ptr main(xe_ptr);
+
+	xe_loop loop;
+	xe_loop_group* group;
+	pthread_t thread;
+
+	uint index;
+	int cpu;
+	int result;
+
+	friend class xe_loop_group;
+public:
+	xe_loop_worker() = default;
+
+	xe_disable_copy_move(xe_loop_worker)
+
+	~xe_loop_worker() = default;
+};
+
+/*
+ * N threads, each running its own xe_loop
+ * with sqpoll, every loop after the first attaches to the first loop's sq thread
+ */
+class xe_loop_group{
+private:
+	int spawn(xe_loop_worker&);
+
+	xe_loop_worker* workers;
+	xe_loop_options options;
+
+	sem_t ready;
+	sem_t go;
+
+	uint count_;
+	uint started;
+	bool failed: 1;
+
+	friend class xe_loop_worker;
+public:
+	/* called on each worker thread before its loop runs */
+	int (*start_callback)(xe_loop_group& group, xe_loop& loop, uint index);
+
+	xe_loop_group(){
+		workers = null;
+
+		count_ = 0;
+		started = 0;
+		failed = false;
+
+		start_callback = null;
+	}
+
+	xe_disable_copy_move(xe_loop_group)
+
+	/*
+	 * cpus: cpu to pin each worker to, null to pin worker i to cpu i
+	 * a negative entry leaves that worker unpinned
+	 */
+	int init(uint count, const xe_loop_options& options, const int* cpus = null);
+	void close();
+
+	int start(); /* spawn the workers and run their loops */
+	int join(); /* wait for every loop to exit, returns the first error */
+
+	uint count() const{
+		return count_;
+	}
+
+	xe_loop& loop(uint index) const{
+		return workers[index].loop;
+	}
+
+	/*
+	 * open one SO_REUSEPORT listener per worker, sockets[i] belongs to loop(i)
+	 * steer: attach a cbpf program that hands connections to the worker
+	 * pinned to the cpu that received them
+	 */
+	int listen(xe_socket* sockets, const sockaddr* addr, socklen_t addrlen, int backlog, bool steer = false);
+
+	~xe_loop_group() = default;
+
+	static xe_cstr class_name();
+};
\ No newline at end of file
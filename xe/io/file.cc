@@ -3,6 +3,19 @@
 #include "file.h"
 #include "../error.h"
 
+/* buffers from the loop's fixed buffer slab skip page pinning */
+static inline xe_op xe_file_read_op(xe_loop& loop, int fd, xe_ptr buf, uint len, long offset){
+	int index = loop.fixed_buffers().index(buf, len);
+
+	return index < 0 ? xe_op::read(fd, buf, len, offset) : xe_op::read_fixed(fd, buf, len, offset, index);
+}
+
+static inline xe_op xe_file_write_op(xe_loop& loop, int fd, xe_cptr buf, uint len, long offset){
+	int index = loop.fixed_buffers().index(buf, len);
+
+	return index < 0 ? xe_op::write(fd, buf, len, offset) : xe_op::write_fixed(fd, buf, len, offset, index);
+}
+
 void xe_open_req::complete(xe_req& req, int res, uint flags){
 	xe_open_req& open_req = (xe_open_req&)req;
 
@@ -30,7 +43,10 @@ xe_open_promise::xe_open_promise(){
 void xe_file::open(int res){
 	opening = false;
 
-	if(res >= 0) fd_ = res;
+	if(res >= 0)
+		fd_ = res;
+	else
+		direct_ = false;
 }
 
 int xe_file::open(xe_open_req& req, xe_op op){
@@ -42,6 +58,7 @@ int xe_file::open(xe_open_req& req, xe_op op){
 
 	req.file = this;
 	opening = true;
+	direct_ = loop_ -> direct_files() != 0;
 
 	return 0;
 }
@@ -62,6 +79,7 @@ xe_open_promise xe_file::open(xe_op op){
 	}else{
 		promise.file = this;
 		opening = true;
+		direct_ = loop_ -> direct_files() != 0;
 	}
 
 	return promise;
@@ -86,7 +104,7 @@ int xe_file::open(xe_open_req& req, xe_cstr path, uint flags){
 }
 
 int xe_file::openat(xe_open_req& req, int dfd, xe_cstr path, uint flags){
-	return open(req, xe_op::openat(dfd, path, flags, 0));
+	return open(req, xe_op::openat(dfd, path, flags, 0, direct_index()));
 }
 
 xe_open_promise xe_file::open(xe_cstr path, uint flags){
@@ -94,7 +112,7 @@ xe_open_promise xe_file::open(xe_cstr path, uint flags){
 }
 
 xe_open_promise xe_file::openat(int dfd, xe_cstr path, uint flags){
-	return open(xe_op::openat(dfd, path, flags, 0));
+	return open(xe_op::openat(dfd, path, flags, 0, direct_index()));
 }
 
 int xe_file::open2_sync(xe_cstr path, open_how* how){
@@ -116,7 +134,7 @@ int xe_file::open2(xe_open_req& req, xe_cstr path, open_how* how){
 }
 
 int xe_file::openat2(xe_open_req& req, int dfd, xe_cstr path, open_how* how){
-	return open(req, xe_op::openat2(dfd, path, how));
+	return open(req, xe_op::openat2(dfd, path, how, direct_index()));
 }
 
 xe_open_promise xe_file::open2(xe_cstr path, open_how* how){
@@ -124,11 +142,11 @@ xe_open_promise xe_file::open2(xe_cstr path, open_how* how){
 }
 
 xe_open_promise xe_file::openat2(int dfd, xe_cstr path, open_how* how){
-	return open(xe_op::openat2(dfd, path, how));
+	return open(xe_op::openat2(dfd, path, how, direct_index()));
 }
 
 int xe_file::read_sync(xe_ptr buf, uint len, long offset){
-	if(fd_ < 0)
+	if(fd_ < 0 || direct_)
 		return XE_STATE;
 	int read = pread(fd_, buf, len, offset);
 
@@ -136,7 +154,7 @@ int xe_file::read_sync(xe_ptr buf, uint len, long offset){
 }
 
 int xe_file::write_sync(xe_cptr buf, uint len, long offset){
-	if(fd_ < 0)
+	if(fd_ < 0 || direct_)
 		return XE_STATE;
 	int wrote = pwrite(fd_, buf, len, offset);
 
@@ -146,29 +164,29 @@ int xe_file::write_sync(xe_cptr buf, uint len, long offset){
 int xe_file::read(xe_req& req, xe_ptr buf, uint len, long offset){
 	if(fd_ < 0)
 		return XE_STATE;
-	return loop_ -> run(req, xe_op::read(fd_, buf, len, offset));
+	return loop_ -> run(req, io(xe_file_read_op(*loop_, fd_, buf, len, offset)));
 }
 
 int xe_file::write(xe_req& req, xe_cptr buf, uint len, long offset){
 	if(fd_ < 0)
 		return XE_STATE;
-	return loop_ -> run(req, xe_op::write(fd_, buf, len, offset));
+	return loop_ -> run(req, io(xe_file_write_op(*loop_, fd_, buf, len, offset)));
 }
 
 xe_promise xe_file::read(xe_ptr buf, uint len, long offset){
 	if(fd_ < 0)
 		return xe_promise::done(XE_STATE);
-	return loop_ -> run(xe_op::read(fd_, buf, len, offset));
+	return loop_ -> run(io(xe_file_read_op(*loop_, fd_, buf, len, offset)));
 }
 
 xe_promise xe_file::write(xe_cptr buf, uint len, long offset){
 	if(fd_ < 0)
 		return xe_promise::done(XE_STATE);
-	return loop_ -> run(xe_op::write(fd_, buf, len, offset));
+	return loop_ -> run(io(xe_file_write_op(*loop_, fd_, buf, len, offset)));
 }
 
 int xe_file::readv_sync(const iovec* iovecs, uint vlen, long offset){
-	if(fd_ < 0)
+	if(fd_ < 0 || direct_)
 		return XE_STATE;
 	int read = preadv(fd_, iovecs, vlen, offset);
 
@@ -176,7 +194,7 @@ int xe_file::readv_sync(const iovec* iovecs, uint vlen, long offset){
 }
 
 int xe_file::writev_sync(const iovec* iovecs, uint vlen, long offset){
-	if(fd_ < 0)
+	if(fd_ < 0 || direct_)
 		return XE_STATE;
 	int wrote = pwritev(fd_, iovecs, vlen, offset);
 
@@ -186,31 +204,34 @@ int xe_file::writev_sync(const iovec* iovecs, uint vlen, long offset){
 int xe_file::readv(xe_req& req, const iovec* iovecs, uint vlen, long offset){
 	if(fd_ < 0)
 		return XE_STATE;
-	return loop_ -> run(req, xe_op::readv(fd_, iovecs, vlen, offset));
+	return loop_ -> run(req, io(xe_op::readv(fd_, iovecs, vlen, offset)));
 }
 
 int xe_file::writev(xe_req& req, const iovec* iovecs, uint vlen, long offset){
 	if(fd_ < 0)
 		return XE_STATE;
-	return loop_ -> run(req, xe_op::writev(fd_, iovecs, vlen, offset));
+	return loop_ -> run(req, io(xe_op::writev(fd_, iovecs, vlen, offset)));
 }
 
 xe_promise xe_file::readv(const iovec* iovecs, uint vlen, long offset){
 	if(fd_ < 0)
 		return xe_promise::done(XE_STATE);
-	return loop_ -> run(xe_op::readv(fd_, iovecs, vlen, offset));
+	return loop_ -> run(io(xe_op::readv(fd_, iovecs, vlen, offset)));
 }
 
 xe_promise xe_file::writev(const iovec* iovecs, uint vlen, long offset){
 	if(fd_ < 0)
 		return xe_promise::done(XE_STATE);
-	return loop_ -> run(xe_op::writev(fd_, iovecs, vlen, offset));
+	return loop_ -> run(io(xe_op::writev(fd_, iovecs, vlen, offset)));
 }
 
 void xe_file::close(){
 	if(fd_ >= 0){
-		::close(fd_);
-
+		if(direct_)
+			loop_ -> close_direct(fd_);
+		else
+			::close(fd_);
 		fd_ = -1;
+		direct_ = false;
 	}
 }
\ No newline at end of file
@@ -48,10 +48,19 @@ private:
 	xe_open_promise open(xe_op);
 	void open(int);
 
+	xe_op io(xe_op op) const{
+		return direct_ ? op.orflags(IOSQE_FIXED_FILE) : op;
+	}
+
+	uint direct_index() const{
+		return loop_ -> direct_files() ? IORING_FILE_INDEX_ALLOC : 0;
+	}
+
 	xe_loop* loop_;
 
 	int fd_;
 	bool opening: 1;
+	bool direct_: 1;
 
 	friend class xe_open_req;
 	friend class xe_open_promise;
@@ -59,6 +68,7 @@ public:
 	xe_file(){
 		fd_ = -1;
 		opening = false;
+		direct_ = false;
 	}
 
 	xe_file(xe_loop& loop): xe_file(){
@@ -79,6 +89,15 @@ public:
 		return fd_;
 	}
 
+	/* fd() is an index in the loop's direct descriptor table */
+	bool direct() const{
+		return direct_;
+	}
+
+	/*
+	 * when the loop has a direct descriptor table, async opens take a slot in it
+	 * and the sync read and write calls return XE_STATE
+	 */
 	int open_sync(xe_cstr path, uint flags);
 	int openat_sync(int dfd, xe_cstr path, uint flags);
 
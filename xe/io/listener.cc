@@ -0,0 +1,214 @@
+#include <unistd.h>
+#include "listener.h"
+#include "../error.h"
+
+/* completion target for cancels nobody waits on */
+static xe_req xe_listener_cancel_req;
+
+void xe_listener::accept_complete(xe_req& req, int res, uint flags){
+	xe_listener& listener = xe_containerof(req, &xe_listener::accept_req);
+
+	if(res >= 0)
+		listener.accepted(res);
+	if(flags & IORING_CQE_F_MORE) [[likely]]
+		return;
+	listener.armed = false;
+
+	if(!listener.active_){
+		/* last completion after a stop, accept_req is released */
+		if(listener.close_callback) listener.close_callback(listener);
+
+		return;
+	}
+
+	if(listener.paused_){
+		/* last completion after a pause */
+		return;
+	}
+
+	/* the kernel dropped the multishot, or a pause was lifted before its cancel completed */
+	if(res >= 0 || res == XE_ECANCELED)
+		res = listener.arm();
+	if(res) listener.stopped(res);
+}
+
+void xe_listener::deliver(xe_loop& loop, xe_hook& hook){
+	xe_listener& listener = xe_containerof(hook, &xe_listener::deliver_hook);
+	xe_coroutine_handle handle;
+	int err;
+
+	loop.cancel(hook);
+
+	if(listener.callback){
+		if(listener.pending.size())
+			listener.callback(listener, listener.pending.size(), listener.pending.data());
+		listener.pending.resize(0);
+
+		if(listener.error_){
+			err = listener.error_;
+			listener.error_ = 0;
+			listener.callback(listener, err, null);
+		}
+	}else if(listener.waiter){
+		handle = listener.waiter;
+		listener.waiter = null;
+		handle.resume();
+	}
+}
+
+int xe_listener::arm(){
+	xe_op op = xe_op::accept(socket_ -> fd(), null, null, flags_, direct_ ? IORING_FILE_INDEX_ALLOC : 0);
+
+	xe_return_error(socket_ -> loop().run(accept_req, op.accept_multishot()));
+
+	armed = true;
+
+	return 0;
+}
+
+int xe_listener::pause(){
+	int res;
+
+	paused_ = true;
+
+	if(!armed)
+		return 0;
+	res = socket_ -> loop().cancel(xe_listener_cancel_req, accept_req, xe_op::cancel(0));
+
+	return res == XE_EINPROGRESS ? 0 : res;
+}
+
+void xe_listener::accepted(int fd){
+	if(!active_ || !pending.push_back(fd)){
+		discard(fd);
+
+		return;
+	}
+
+	connections_++;
+	schedule();
+
+	if(max_connections_ && connections_ >= max_connections_ && !paused_){
+		int err = pause();
+
+		if(err) stopped(err);
+	}
+}
+
+void xe_listener::stopped(int err){
+	active_ = false;
+	error_ = err;
+	schedule();
+}
+
+void xe_listener::schedule(){
+	if(!deliver_hook.active()) socket_ -> loop().check(deliver_hook);
+}
+
+void xe_listener::discard(int fd){
+	if(direct_)
+		socket_ -> loop().close_direct(fd);
+	else
+		::close(fd);
+}
+
+int xe_listener::set_direct(bool direct){
+	if(active_ || armed)
+		return XE_STATE;
+	if(direct && !socket_ -> loop().direct_files())
+		return XE_STATE;
+	direct_ = direct;
+
+	return 0;
+}
+
+void xe_listener::set_max_connections(uint max){
+	max_connections_ = max;
+
+	if(paused_ && (!max || connections_ < max))
+		release();
+}
+
+int xe_listener::start(uint flags){
+	if(active_)
+		return XE_EALREADY;
+	if(armed)
+		return XE_STATE;
+	flags_ = flags;
+	error_ = 0;
+	paused_ = max_connections_ && connections_ >= max_connections_;
+
+	if(!paused_)
+		xe_return_error(arm());
+	active_ = true;
+
+	return 0;
+}
+
+int xe_listener::stop(){
+	int res;
+
+	if(!active_)
+		return XE_EALREADY;
+	active_ = false;
+
+	if(armed){
+		res = socket_ -> loop().cancel(xe_listener_cancel_req, accept_req, xe_op::cancel(0));
+
+		if(res != XE_EINPROGRESS){
+			active_ = true;
+
+			return res;
+		}
+	}
+
+	paused_ = false;
+
+	/* wake a coroutine waiting on the listener, it gets XE_ECANCELED */
+	if(waiter) schedule();
+
+	return armed ? XE_EINPROGRESS : 0;
+}
+
+void xe_listener::release(){
+	int err;
+
+	if(connections_) connections_--;
+	if(!paused_ || (max_connections_ && connections_ >= max_connections_))
+		return;
+	paused_ = false;
+
+	/* still armed when the cancel has not completed, it stays armed then */
+	if(!active_ || armed)
+		return;
+	err = arm();
+
+	if(err) stopped(err);
+}
+
+void xe_listener::close(){
+	for(int fd : pending)
+		discard(fd);
+	if(deliver_hook.active())
+		socket_ -> loop().cancel(deliver_hook);
+	connections_ -= xe_min<uint>(connections_, pending.size());
+	pending.clear();
+	batch.clear();
+}
+
+int xe_listener::await_resume(){
+	int err;
+
+	if(!pending.size()){
+		err = error_;
+		error_ = 0;
+
+		return err ? err : XE_ECANCELED;
+	}
+
+	if(!batch.copy(pending.data(), pending.size()))
+		return XE_ENOMEM;
+	pending.resize(0);
+
+	return batch.size();
+}
\ No newline at end of file
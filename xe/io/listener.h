@@ -0,0 +1,138 @@
+#pragma once
+#include "xstd/types.h"
+#include "xstd/vector.h"
+#include "xutil/util.h"
+#include "socket.h"
+
+/*
+ * keeps one multishot accept armed on a listening socket
+ * connections accepted during a loop iteration are handed over together,
+ * to the callback, or to a coroutine awaiting the listener
+ *
+ * with a connection cap the accept is paused at the cap, and resumed
+ * once release() brings the count back under it. connections left in the
+ * kernel's backlog meanwhile are accepted on resume
+ *
+ * after stop() the accept may still be in flight, the listener
+ * can only be freed once close_callback has run, or stop() returned 0,
+ * and after close()
+ */
+class xe_listener{
+private:
+	static void accept_complete(xe_req&, int, uint);
+	static void deliver(xe_loop&, xe_hook&);
+
+	int arm();
+	int pause();
+	void accepted(int);
+	void stopped(int);
+	void schedule();
+	void discard(int);
+
+	xe_socket* socket_;
+
+	xe_req accept_req;
+	xe_hook deliver_hook;
+
+	xe_vector<int> pending; /* accepted but not handed over */
+	xe_vector<int> batch; /* the last batch handed to a coroutine */
+	xe_coroutine_handle waiter;
+
+	uint flags_;
+	uint connections_;
+	uint max_connections_;
+	int error_;
+
+	bool direct_: 1;
+	bool active_: 1;
+	bool armed: 1;
+	bool paused_: 1;
+public:
+	/*
+	 * result > 0: fds holds result new connections, pass them to xe_socket::accept,
+	 * 	or xe_socket::accept_direct when direct
+	 * result < 0: the listener has stopped
+	 */
+	typedef void (*xe_callback)(xe_listener& listener, int result, int* fds);
+
+	xe_callback callback;
+	void (*close_callback)(xe_listener& listener); /* the accept ended after a stop */
+
+	xe_listener(xe_socket& socket){
+		socket_ = &socket;
+
+		accept_req.event = accept_complete;
+		deliver_hook.callback = deliver;
+
+		flags_ = 0;
+		connections_ = 0;
+		max_connections_ = 0;
+		error_ = 0;
+
+		direct_ = false;
+		active_ = false;
+		armed = false;
+		paused_ = false;
+
+		callback = null;
+		close_callback = null;
+	}
+
+	xe_disable_copy_move(xe_listener)
+
+	xe_socket& socket() const{
+		return *socket_;
+	}
+
+	/* accept into the loop's direct descriptor table, only while stopped */
+	int set_direct(bool direct);
+
+	bool direct() const{
+		return direct_;
+	}
+
+	/* 0 for no cap */
+	void set_max_connections(uint max);
+
+	/* connections accepted and not yet released */
+	uint connections() const{
+		return connections_;
+	}
+
+	bool paused() const{
+		return paused_;
+	}
+
+	bool active() const{
+		return active_;
+	}
+
+	/* flags are accept4 flags */
+	int start(uint flags = 0);
+
+	/* XE_EINPROGRESS if the accept is still armed, close_callback runs once it ends */
+	int stop();
+
+	/* a connection from this listener was closed */
+	void release();
+
+	/* drop connections not handed over yet */
+	void close();
+
+	bool await_ready() const{
+		return pending.size() || !active_;
+	}
+
+	void await_suspend(xe_coroutine_handle handle){
+		waiter = handle;
+	}
+
+	/* same results as the callback, the fds are in accepted() */
+	int await_resume();
+
+	int* accepted(){
+		return batch.data();
+	}
+
+	~xe_listener() = default;
+};
\ No newline at end of file
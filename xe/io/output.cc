@@ -0,0 +1,183 @@
+#include <limits.h>
+#include "output.h"
+#include "../error.h"
+
+void xe_output_stream::flush_callback(xe_loop& loop, xe_hook& hook){
+	xe_output_stream& stream = xe_containerof(hook, &xe_output_stream::flush_hook);
+	int err;
+
+	loop.cancel(hook);
+	stream.scheduled = false;
+
+	if(stream.error_)
+		return;
+	err = stream.flush();
+
+	if(err && stream.callback) stream.callback(stream, err);
+}
+
+void xe_output_stream::send_callback(xe_req& req, int res){
+	xe_containerof(req, &xe_output_stream::send_req).sent(res);
+}
+
+int xe_output_stream::queue(xe_cptr buf, size_t len, bool copy){
+	xe_batch& batch = *pending;
+
+	if(error_)
+		return error_;
+	if(!len)
+		return 0;
+	if(copy){
+		if(!batch.data.append((const byte*)buf, len))
+			return XE_ENOMEM;
+		if(batch.iovecs.size() && !batch.iovecs.back().iov_base){
+			/* extend the last copied run */
+			batch.iovecs.back().iov_len += len;
+		}else if(!batch.iovecs.push_back({ null, len })){
+			batch.data.resize(batch.data.size() - len);
+
+			return XE_ENOMEM;
+		}
+	}else if(!batch.iovecs.push_back({ (xe_ptr)buf, len })){
+		return XE_ENOMEM;
+	}
+
+	buffered_ += len;
+
+	if(sending || scheduled)
+		return 0;
+	/* let the rest of this iteration's writes join the batch */
+	if(socket_ -> loop().prepare(flush_hook))
+		return flush();
+	scheduled = true;
+
+	return 0;
+}
+
+int xe_output_stream::send(){
+	msg.msg_iov = inflight -> iovecs.data() + iov_head;
+	msg.msg_iovlen = xe_min<size_t>(inflight -> iovecs.size() - iov_head, IOV_MAX);
+
+	return socket_ -> sendmsg(send_req, &msg, msg_flags);
+}
+
+void xe_output_stream::swap(){
+	xe_batch* batch = pending;
+	byte* data;
+
+	pending = inflight;
+	inflight = batch;
+	data = batch -> data.data();
+
+	/* the copied data no longer moves, point the iovecs at it */
+	for(iovec& iov : batch -> iovecs){
+		if(iov.iov_base)
+			continue;
+		iov.iov_base = data;
+		data += iov.iov_len;
+	}
+
+	iov_head = 0;
+	sending = true;
+}
+
+void xe_output_stream::sent(int res){
+	xe_vector<iovec>& iovecs = inflight -> iovecs;
+	size_t left;
+	int err;
+
+	if(res <= 0){
+		fail(res ? res : XE_ECONNRESET);
+
+		return;
+	}
+
+	buffered_ -= res;
+	left = res;
+
+	while(left){
+		iovec& iov = iovecs[iov_head];
+
+		if(left < iov.iov_len){
+			iov.iov_base = (byte*)iov.iov_base + left;
+			iov.iov_len -= left;
+
+			break;
+		}
+
+		left -= iov.iov_len;
+		iov_head++;
+	}
+
+	if(iov_head == iovecs.size()){
+		inflight -> data.resize(0);
+		iovecs.resize(0);
+		sending = false;
+
+		if(!pending -> iovecs.size()){
+			if(callback) callback(*this, 0);
+
+			return;
+		}
+
+		swap();
+	}
+
+	err = send();
+
+	if(err) fail(err);
+}
+
+void xe_output_stream::reset(int err){
+	error_ = err;
+	sending = false;
+	buffered_ = 0;
+
+	for(xe_batch& batch : batches){
+		batch.data.resize(0);
+		batch.iovecs.resize(0);
+	}
+}
+
+void xe_output_stream::fail(int err){
+	reset(err);
+
+	if(callback) callback(*this, err);
+}
+
+int xe_output_stream::write(xe_cptr buf, size_t len){
+	return queue(buf, len, true);
+}
+
+int xe_output_stream::write_ref(xe_cptr buf, size_t len){
+	return queue(buf, len, false);
+}
+
+int xe_output_stream::flush(){
+	int err;
+
+	if(error_)
+		return error_;
+	if(sending || !pending -> iovecs.size())
+		return 0;
+	swap();
+	err = send();
+
+	if(err) reset(err);
+	return err;
+}
+
+void xe_output_stream::close(){
+	if(scheduled) socket_ -> loop().cancel(flush_hook);
+
+	for(xe_batch& batch : batches){
+		batch.data.clear();
+		batch.iovecs.clear();
+	}
+
+	iov_head = 0;
+	buffered_ = 0;
+	error_ = 0;
+	scheduled = false;
+	sending = false;
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+#include <sys/uio.h>
+#include "xstd/types.h"
+#include "xstd/vector.h"
+#include "xutil/util.h"
+#include "socket.h"
+
+enum xe_output_size{
+	XE_OUTPUT_HIGH_WATER = 1024 * 1024
+};
+
+/*
+ * buffered writes to a socket, everything written during one loop
+ * iteration goes out in a single sendmsg
+ */
+class xe_output_stream{
+private:
+	struct xe_batch{
+		xe_vector<byte> data; /* copied writes */
+		xe_vector<iovec> iovecs; /* iov_base is null for copied writes until sent */
+	};
+
+	static void flush_callback(xe_loop&, xe_hook&);
+	static void send_callback(xe_req&, int);
+
+	int queue(xe_cptr buf, size_t len, bool copy);
+	int send();
+	void swap();
+	void sent(int);
+	void reset(int);
+	void fail(int);
+
+	xe_socket* socket_;
+
+	xe_hook flush_hook; /* flushes before the loop waits */
+	xe_req send_req;
+	msghdr msg;
+
+	xe_batch batches[2];
+	xe_batch* pending; /* collecting writes */
+	xe_batch* inflight; /* being sent */
+
+	size_t iov_head; /* first unsent iovec of the inflight batch */
+	size_t buffered_;
+	size_t high_water_;
+
+	uint msg_flags;
+	int error_;
+
+	bool scheduled: 1;
+	bool sending: 1;
+public:
+	/*
+	 * result == 0: everything written has been sent
+	 * result < 0: the stream failed, later writes return the same error
+	 */
+	typedef void (*xe_callback)(xe_output_stream& stream, int result);
+
+	xe_callback callback;
+
+	xe_output_stream(xe_socket& socket){
+		socket_ = &socket;
+
+		flush_hook.callback = flush_callback;
+		send_req.callback = send_callback;
+		xe_zero(&msg);
+
+		pending = &batches[0];
+		inflight = &batches[1];
+
+		iov_head = 0;
+		buffered_ = 0;
+		high_water_ = XE_OUTPUT_HIGH_WATER;
+
+		msg_flags = MSG_NOSIGNAL;
+		error_ = 0;
+
+		scheduled = false;
+		sending = false;
+
+		callback = null;
+	}
+
+	xe_disable_copy_move(xe_output_stream)
+
+	xe_socket& socket() const{
+		return *socket_;
+	}
+
+	void set_high_water(size_t bytes){
+		high_water_ = bytes;
+	}
+
+	void set_flags(uint flags){
+		msg_flags = flags;
+	}
+
+	/* buf is copied */
+	int write(xe_cptr buf, size_t len);
+
+	/* buf is not copied and must stay valid until the callback reports everything sent */
+	int write_ref(xe_cptr buf, size_t len);
+
+	/* send now instead of at the end of the loop iteration */
+	int flush();
+
+	/* bytes written but not yet sent */
+	size_t buffered() const{
+		return buffered_;
+	}
+
+	/* past the high water mark, hold off writing until the callback */
+	bool full() const{
+		return buffered_ >= high_water_;
+	}
+
+	/* drop unsent writes, only once nothing is in flight */
+	void close();
+
+	~xe_output_stream() = default;
+};
\ No newline at end of file
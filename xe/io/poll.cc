@@ -2,12 +2,18 @@
 #include "poll.h"
 #include "../error.h"
 
-void xe_poll::poll_cb(xe_req& req, int events){
+void xe_poll::poll_cb(xe_req& req, int events, uint flags){
 	xe_poll& handle = xe_containerof(req, &xe_poll::poll_req);
+	bool more = flags & IORING_CQE_F_MORE;
 	int res;
 
-	if(!handle.active) [[unlikely]]
+	if(!handle.active) [[unlikely]] {
+		/* a multishot poll stays armed until its cancel completes */
+		if(more) return;
+
 		goto done;
+	}
+
 	res = events;
 
 	if(events == XE_ECANCELED)
@@ -20,11 +26,25 @@ void xe_poll::poll_cb(xe_req& req, int events){
 		 */
 		events &= handle.events_;
 
-		if(!events) goto ok;
+		if(!events){
+			if(more) return;
+
+			goto ok;
+		}
 	}else if(handle.events_ & XE_POLL_ONESHOT){
 		handle.active = false;
 	}
 
+	if(more){
+		/*
+		 * still armed, any change to the events from the callback
+		 * has to go through a cancel
+		 */
+		if(handle.poll_callback) [[likely]]
+			handle.poll_callback(handle, events);
+		return;
+	}
+
 	if(handle.poll_callback) [[likely]] {
 		/* temporarily prevent a modify req from being started */
 		handle.updated = true;
@@ -35,8 +55,9 @@ void xe_poll::poll_cb(xe_req& req, int events){
 	if(!handle.active) [[unlikely]]
 		goto done;
 ok:
+	/* rearm, a multishot poll only gets here once the kernel ends it */
 	handle.updated = false;
-	res = handle.loop_ -> run(handle.poll_req, xe_op::poll(handle.fd_, handle.events_));
+	res = handle.arm(handle.events_);
 
 	if(!res) [[likely]]
 		return;
@@ -83,6 +104,18 @@ void xe_poll::cancel_cb(xe_req& req, int cancel_res){
 	}
 }
 
+int xe_poll::arm(uint events){
+	xe_op op = xe_op::poll(fd_, events);
+
+	/*
+	 * a multishot poll reports readiness at arm time,
+	 * after that only new wakeups, so callers drain until EAGAIN
+	 */
+	if(multishot_ && !(events & XE_POLL_ONESHOT))
+		op.poll_add_multi();
+	return loop_ -> run(poll_req, op);
+}
+
 int xe_poll::update_poll(){
 	if(updated){
 		/* poll already completing */
@@ -184,7 +217,7 @@ int xe_poll::poll(uint events){
 		events |= XE_POLL_ERR | XE_POLL_HUP | XE_POLL_NVAL | XE_POLL_RDHUP;
 
 		if(!polling){
-			xe_return_error(loop_ -> run(poll_req, xe_op::poll(fd_, events)));
+			xe_return_error(arm(events));
 
 			polling = true;
 		}else{
@@ -207,6 +240,14 @@ int xe_poll::poll(uint events){
 	return 0;
 }
 
+int xe_poll::set_multishot(bool multishot){
+	if(polling || modifying)
+		return XE_STATE;
+	multishot_ = multishot;
+
+	return 0;
+}
+
 int xe_poll::close(){
 	if(closing)
 		return XE_EALREADY;
@@ -25,9 +25,10 @@ enum{
 
 class xe_poll{
 private:
-	static void poll_cb(xe_req&, int);
+	static void poll_cb(xe_req&, int, uint);
 	static void cancel_cb(xe_req&, int);
 
+	int arm(uint);
 	int update_poll();
 	void check_close();
 
@@ -46,12 +47,13 @@ private:
 	bool updated: 1;
 	bool restart: 1;
 	bool closing: 1;
+	bool multishot_: 1;
 public:
 	void (*poll_callback)(xe_poll& poll, int result);
 	void (*close_callback)(xe_poll& poll);
 
 	xe_poll(){
-		poll_req.callback = poll_cb;
+		poll_req.event = poll_cb;
 		cancel_req.callback = cancel_cb;
 
 		active = false;
@@ -60,6 +62,7 @@ public:
 		updated = false;
 		restart = false;
 		closing = false;
+		multishot_ = false;
 
 		poll_callback = null;
 		close_callback = null;
@@ -87,6 +90,19 @@ public:
 		fd_ = fd;
 	}
 
+	/*
+	 * keep one poll request armed across events instead of submitting a new one after each,
+	 * changing the events still restarts it. only while not polling
+	 *
+	 * edge triggered: an event is reported once per wakeup,
+	 * the callback has to read, write or accept until EAGAIN
+	 */
+	int set_multishot(bool multishot);
+
+	bool multishot() const{
+		return multishot_;
+	}
+
 	int poll(uint events);
 	int close();
 
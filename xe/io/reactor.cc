@@ -0,0 +1,313 @@
+#include "xutil/mem.h"
+#include "reactor.h"
+#include "../error.h"
+
+enum{
+	XE_REACTOR_MODES = XE_POLL_EDGE_TRIGGERED | XE_POLL_ONESHOT,
+	XE_REACTOR_ALWAYS = XE_POLL_ERR | XE_POLL_HUP
+};
+
+xe_reactor::xe_entry::xe_entry(xe_reactor& reactor_, int fd_, uint events_, xe_ptr data_){
+	poll_req.event = poll_callback;
+	ctl_req.callback = ctl_callback;
+
+	reactor = &reactor_;
+	data = data_;
+	fd = fd_;
+	events = events_;
+	armed_events = 0;
+	ready = 0;
+
+	armed = false;
+	controlling = false;
+	changed = false;
+	queued = false;
+	idle = false;
+	removed = false;
+}
+
+void xe_reactor::poll_callback(xe_req& req, int res, uint flags){
+	xe_entry& entry = xe_containerof(req, &xe_entry::poll_req);
+	xe_reactor& reactor = *entry.reactor;
+
+	if(res > 0)
+		reactor.ready(entry, res);
+	else if(res < 0 && res != XE_ECANCELED)
+		reactor.ready(entry, XE_POLL_ERR);
+	if(flags & IORING_CQE_F_MORE) [[likely]]
+		return;
+	reactor.disarmed(entry, res);
+}
+
+void xe_reactor::ctl_callback(xe_req& req, int res){
+	xe_entry& entry = xe_containerof(req, &xe_entry::ctl_req);
+	xe_reactor& reactor = *entry.reactor;
+
+	entry.controlling = false;
+
+	/* the poll ended before the update reached it, arm again with the new events */
+	if(res == XE_ENOENT) entry.idle = false;
+
+	reactor.change(entry);
+}
+
+void xe_reactor::prepare_callback(xe_loop& loop, xe_hook& hook){
+	xe_reactor& reactor = xe_containerof(hook, &xe_reactor::prepare_hook);
+	xe_entry* entry;
+
+	loop.cancel(hook);
+
+	/* applying a change may queue it again */
+	for(size_t i = 0; i < reactor.changes.size(); i++){
+		entry = reactor.changes[i];
+		entry -> changed = false;
+		reactor.apply(*entry);
+	}
+
+	reactor.changes.resize(0);
+}
+
+void xe_reactor::check_callback(xe_loop& loop, xe_hook& hook){
+	xe_reactor& reactor = xe_containerof(hook, &xe_reactor::check_hook);
+
+	xe_entry* entry;
+
+	loop.cancel(hook);
+
+	while(!reactor.ready_.empty()){
+		entry = &reactor.ready_.front();
+
+		if(!entry -> removed && !reactor.batch.push_back({ entry -> fd, entry -> ready, entry -> data })){
+			/* the rest stay queued for the next iteration */
+			loop.check(hook);
+
+			break;
+		}
+
+		reactor.ready_.erase(*entry);
+		entry -> queued = false;
+		entry -> ready = 0;
+		reactor.release(*entry);
+	}
+
+	if(reactor.batch.size() && reactor.callback)
+		reactor.callback(reactor, reactor.batch.data(), reactor.batch.size());
+	reactor.batch.resize(0);
+}
+
+int xe_reactor::validate(uint events) const{
+	if(closing)
+		return XE_STATE;
+	if(events & XE_POLL_EXCLUSIVE)
+		return XE_EOPNOTSUPP;
+	if(!callback)
+		return XE_STATE;
+	return 0;
+}
+
+xe_reactor::xe_entry* xe_reactor::get(int fd) const{
+	if(fd < 0 || (size_t)fd >= table.size())
+		return null;
+	return table[fd];
+}
+
+void xe_reactor::change(xe_entry& entry){
+	if(entry.changed)
+		return;
+	if(!changes.push_back(&entry)){
+		/* apply it right away instead of batching */
+		apply(entry);
+
+		return;
+	}
+
+	entry.changed = true;
+
+	if(!prepare_hook.active()) loop_ -> prepare(prepare_hook);
+}
+
+void xe_reactor::apply(xe_entry& entry){
+	uint events = entry.events;
+	int res;
+
+	/* ctl_callback queues the entry again */
+	if(entry.controlling)
+		return;
+	if(!entry.armed){
+		if(entry.removed)
+			release(entry);
+		else if(!entry.idle && (res = arm(entry))){
+			entry.idle = true;
+			ready(entry, XE_POLL_ERR);
+		}
+
+		return;
+	}
+
+	if(!entry.removed && events == entry.armed_events)
+		return;
+	if(!entry.removed && (events & XE_REACTOR_MODES) == (entry.armed_events & XE_REACTOR_MODES)){
+		/* same mode, change the mask in place */
+		res = loop_ -> cancel(entry.ctl_req, entry.poll_req,
+			xe_op::poll_update(events & ~XE_REACTOR_MODES, 0).poll_update_events(), &entry.ctl_info, &entry.poll_info);
+		entry.armed_events = events;
+	}else{
+		/* the mode is fixed when the poll is armed, remove it and arm again from disarmed() */
+		res = loop_ -> cancel(entry.ctl_req, entry.poll_req, xe_op::poll_cancel(), &entry.ctl_info, &entry.poll_info);
+
+		if(!res){
+			/* was never submitted */
+			entry.armed = false;
+			apply(entry);
+
+			return;
+		}
+	}
+
+	if(res == XE_EINPROGRESS)
+		entry.controlling = true;
+	else if(res){
+		entry.idle = true;
+		ready(entry, XE_POLL_ERR);
+	}
+}
+
+int xe_reactor::arm(xe_entry& entry){
+	uint events = entry.events;
+	xe_op op = xe_op::poll(entry.fd, events & ~XE_REACTOR_MODES);
+
+	/*
+	 * a new poll reports readiness at arm time. level triggered and oneshot fds
+	 * use a single shot poll, disarmed() arms level triggered ones again after delivery
+	 */
+	if((events & XE_REACTOR_MODES) == XE_POLL_EDGE_TRIGGERED)
+		op.poll_add_multi();
+
+	xe_return_error(loop_ -> run(entry.poll_req, op, &entry.poll_info));
+
+	entry.armed = true;
+	entry.armed_events = events;
+
+	return 0;
+}
+
+void xe_reactor::disarmed(xe_entry& entry, int res){
+	entry.armed = false;
+
+	if(entry.removed){
+		release(entry);
+
+		return;
+	}
+
+	if(res < 0 && res != XE_ECANCELED)
+		entry.idle = true;
+	else if(res > 0 && entry.armed_events & XE_POLL_ONESHOT)
+		entry.idle = true;
+	/*
+	 * a level triggered poll fired, a multishot poll the kernel ended, or one removed to change modes.
+	 * the change is applied from the prepare hook, after the check hook has delivered the events
+	 */
+	change(entry);
+}
+
+void xe_reactor::ready(xe_entry& entry, uint events){
+	if(entry.removed)
+		return;
+	entry.ready |= events;
+
+	if(entry.queued)
+		return;
+	ready_.append(entry);
+	entry.queued = true;
+
+	if(!check_hook.active()) loop_ -> check(check_hook);
+}
+
+void xe_reactor::release(xe_entry& entry){
+	if(!entry.removed || entry.armed || entry.controlling || entry.changed || entry.queued)
+		return;
+	xe_delete(&entry);
+	entries--;
+
+	if(closing && !entries){
+		closing = false;
+
+		if(close_callback) close_callback(*this);
+	}
+}
+
+int xe_reactor::add(int fd, uint events, xe_ptr data){
+	xe_entry* entry;
+	size_t size;
+
+	xe_return_error(validate(events));
+
+	if(fd < 0)
+		return XE_EBADF;
+	if(get(fd))
+		return XE_EEXIST;
+	size = table.size();
+
+	if((size_t)fd >= size){
+		if(!table.resize(xe_max<size_t>(fd + 1, size * 2)))
+			return XE_ENOMEM;
+		xe_zero(table.data() + size, table.size() - size);
+	}
+
+	entry = xe_new<xe_entry>(*this, fd, events | XE_REACTOR_ALWAYS, data);
+
+	if(!entry)
+		return XE_ENOMEM;
+	table[fd] = entry;
+	count_++;
+	entries++;
+	change(*entry);
+
+	return 0;
+}
+
+int xe_reactor::mod(int fd, uint events, xe_ptr data){
+	xe_entry* entry = get(fd);
+
+	xe_return_error(validate(events));
+
+	if(!entry)
+		return XE_ENOENT;
+	entry -> events = events | XE_REACTOR_ALWAYS;
+	entry -> data = data;
+	entry -> idle = false;
+	change(*entry);
+
+	return 0;
+}
+
+int xe_reactor::del(int fd){
+	xe_entry* entry = get(fd);
+
+	if(!entry)
+		return XE_ENOENT;
+	table[fd] = null;
+	count_--;
+
+	entry -> removed = true;
+	change(*entry);
+
+	return 0;
+}
+
+int xe_reactor::close(){
+	if(closing)
+		return XE_EALREADY;
+	for(size_t fd = 0; fd < table.size(); fd++){
+		if(table[fd]) del((int)fd);
+	}
+
+	table.clear();
+
+	if(!entries)
+		return 0;
+	closing = true;
+
+	return XE_EINPROGRESS;
+}
\ No newline at end of file
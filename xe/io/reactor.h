@@ -0,0 +1,132 @@
+#pragma once
+#include "xstd/types.h"
+#include "xstd/vector.h"
+#include "xstd/linked_list.h"
+#include "xutil/util.h"
+#include "poll.h"
+
+struct xe_reactor_event{
+	int fd;
+	uint events;
+	xe_ptr data;
+};
+
+/*
+ * epoll style readiness for many fds on one loop
+ * interest changes are submitted together before the loop waits,
+ * and the fds that became ready are delivered together after completions are processed
+ *
+ * events are XE_POLL_* flags, level triggered by default,
+ * or with XE_POLL_EDGE_TRIGGERED or XE_POLL_ONESHOT
+ *
+ * level triggered fds are watched with a oneshot poll armed again after every delivery,
+ * so an fd left ready is reported again the next iteration.
+ * edge triggered fds keep one multishot poll, and are reported once per wakeup
+ */
+class xe_reactor{
+private:
+	class xe_entry : protected xe_linked_node{
+	private:
+		xe_reactor* reactor;
+
+		xe_req poll_req;
+		xe_req ctl_req; /* poll update and remove */
+		xe_req_info poll_info;
+		xe_req_info ctl_info;
+
+		xe_ptr data;
+		int fd;
+		uint events; /* wanted */
+		uint armed_events; /* what the poll request is watching */
+		uint ready;
+
+		bool armed: 1; /* the poll request is in flight */
+		bool controlling: 1; /* ctl_req is in flight */
+		bool changed: 1; /* in the change list */
+		bool queued: 1; /* in the ready list */
+		bool idle: 1; /* oneshot fired or the poll failed, waits for a mod */
+		bool removed: 1;
+
+		friend class xe_reactor;
+	public:
+		xe_entry(xe_reactor& reactor, int fd, uint events, xe_ptr data);
+
+		xe_disable_copy_move(xe_entry)
+
+		~xe_entry() = default;
+	};
+
+	static void poll_callback(xe_req&, int, uint);
+	static void ctl_callback(xe_req&, int);
+	static void prepare_callback(xe_loop&, xe_hook&);
+	static void check_callback(xe_loop&, xe_hook&);
+
+	int validate(uint) const;
+	xe_entry* get(int) const;
+	void change(xe_entry&);
+	void apply(xe_entry&);
+	int arm(xe_entry&);
+	void disarmed(xe_entry&, int);
+	void ready(xe_entry&, uint);
+	void release(xe_entry&);
+
+	xe_loop* loop_;
+
+	xe_hook prepare_hook; /* submits interest changes */
+	xe_hook check_hook; /* delivers ready fds */
+
+	xe_vector<xe_entry*> table; /* by fd */
+	xe_vector<xe_entry*> changes;
+	xe_linked_list<xe_entry> ready_;
+	xe_vector<xe_reactor_event> batch;
+
+	uint count_; /* registered fds */
+	uint entries; /* allocated, including removed ones still in flight */
+
+	bool closing: 1;
+public:
+	/* events is valid until the callback returns, deleted fds may still appear in the same batch */
+	typedef void (*xe_callback)(xe_reactor& reactor, xe_reactor_event* events, uint count);
+
+	xe_callback callback;
+	void (*close_callback)(xe_reactor& reactor);
+
+	xe_reactor(){
+		prepare_hook.callback = prepare_callback;
+		check_hook.callback = check_callback;
+
+		count_ = 0;
+		entries = 0;
+		closing = false;
+
+		callback = null;
+		close_callback = null;
+	}
+
+	xe_reactor(xe_loop& loop): xe_reactor(){
+		loop_ = &loop;
+	}
+
+	xe_disable_copy_move(xe_reactor)
+
+	void set_loop(xe_loop& loop){
+		loop_ = &loop;
+	}
+
+	xe_loop& loop() const{
+		return *loop_;
+	}
+
+	uint count() const{
+		return count_;
+	}
+
+	int add(int fd, uint events, xe_ptr data = null);
+	int mod(int fd, uint events, xe_ptr data = null);
+	int del(int fd);
+
+	/* delete every fd, XE_EINPROGRESS if the close callback will run once they are all released */
+	int close();
+
+	~xe_reactor() = default;
+};
\ No newline at end of file
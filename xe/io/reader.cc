@@ -0,0 +1,213 @@
+#include <fcntl.h>
+#include "xutil/mem.h"
+#include "reader.h"
+#include "../error.h"
+
+enum{
+	XE_FILE_READER_ALIGN = 4096
+};
+
+/* completion target for cancels nobody waits on */
+static xe_req xe_file_reader_cancel_req;
+
+void xe_file_reader::xe_read::complete(xe_req& req, int res, uint flags){
+	xe_read& read = (xe_read&)req;
+	xe_file_reader& reader = *read.reader;
+
+	read.inflight = false;
+	read.done = true;
+	read.result = res;
+	reader.pending--;
+	reader.deliver();
+}
+
+void xe_file_reader::open_callback(xe_open_req& req, int result){
+	xe_file_reader& reader = xe_containerof(req, &xe_file_reader::open_req);
+
+	reader.opening = false;
+
+	if(result == XE_EINVAL && reader.o_direct && !reader.ended){
+		/* no O_DIRECT on this filesystem */
+		reader.o_direct = false;
+		result = reader.file_.open(reader.open_req, reader.path, O_RDONLY);
+
+		if(!result){
+			reader.opening = true;
+
+			return;
+		}
+	}
+
+	reader.path = null;
+
+	if(result)
+		reader.end(result);
+	else if(!reader.ended){
+		for(uint i = 0; i < reader.depth_ && !reader.ended; i++){
+			result = reader.submit(reader.reads[i]);
+
+			if(result) reader.end(result);
+		}
+	}
+
+	reader.deliver();
+}
+
+int xe_file_reader::submit(xe_read& read){
+	xe_return_error(file_.read(read, read.buf, chunk_size_, offset));
+
+	offset += chunk_size_;
+	read.inflight = true;
+	pending++;
+
+	return 0;
+}
+
+void xe_file_reader::deliver(){
+	int res;
+
+	while(!ended){
+		xe_read& read = reads[head];
+
+		if(!read.done)
+			break;
+		read.done = false;
+		res = read.result;
+
+		if(res <= 0){
+			end(res);
+
+			break;
+		}
+
+		callback(*this, res, read.buf);
+
+		if(ended)
+			break;
+		if((uint)res < chunk_size_){
+			/* short read, the end of the file */
+			end(0);
+
+			break;
+		}
+
+		head = head + 1 < depth_ ? head + 1 : 0;
+		res = submit(read);
+
+		if(res) end(res);
+	}
+
+	if(!active_ || !ended || pending || opening)
+		return;
+	active_ = false;
+	file_.close();
+	callback(*this, result_, null);
+}
+
+void xe_file_reader::end(int res){
+	ended = true;
+	result_ = res;
+
+	/* reads past the end of the file complete with 0 on their own */
+	if(!res)
+		return;
+	for(uint i = 0; i < depth_; i++){
+		if(reads[i].inflight)
+			file_.loop().cancel(xe_file_reader_cancel_req, reads[i], xe_op::cancel(0));
+	}
+}
+
+int xe_file_reader::init(uint depth, uint chunk_size){
+	xe_fixed_buffers& fixed = file_.loop().fixed_buffers();
+	xe_read* read;
+
+	if(reads)
+		return XE_STATE;
+	if(!depth || !chunk_size || chunk_size % XE_FILE_READER_ALIGN)
+		return XE_EINVAL;
+	reads = xe_alloc<xe_read>(depth);
+
+	if(!reads)
+		return XE_ENOMEM;
+	for(uint i = 0; i < depth; i++){
+		read = &reads[i];
+
+		xe_construct(read);
+
+		read -> reader = this;
+		read -> buf = (byte*)fixed.acquire(chunk_size);
+
+		if(!read -> buf)
+			read -> buf = xe_alloc_aligned<byte>(XE_FILE_READER_ALIGN, chunk_size);
+		if(!read -> buf){
+			depth_ = i + 1;
+			close();
+
+			return XE_ENOMEM;
+		}
+	}
+
+	depth_ = depth;
+	chunk_size_ = chunk_size;
+
+	return 0;
+}
+
+int xe_file_reader::open(xe_cstr path_, long offset_){
+	if(!reads || !callback)
+		return XE_STATE;
+	if(active_)
+		return XE_EALREADY;
+	if(offset_ < 0 || offset_ % XE_FILE_READER_ALIGN)
+		return XE_EINVAL;
+	xe_return_error(file_.open(open_req, path_, O_RDONLY | O_DIRECT));
+
+	for(uint i = 0; i < depth_; i++)
+		reads[i].done = false;
+	path = path_;
+	offset = offset_;
+	head = 0;
+	result_ = 0;
+
+	active_ = true;
+	opening = true;
+	ended = false;
+	o_direct = true;
+
+	return 0;
+}
+
+int xe_file_reader::stop(){
+	if(!active_)
+		return XE_STATE;
+	if(ended)
+		return XE_EALREADY;
+	end(XE_ECANCELED);
+
+	return 0;
+}
+
+void xe_file_reader::close(){
+	xe_fixed_buffers& fixed = file_.loop().fixed_buffers();
+	byte* buf;
+
+	file_.close();
+
+	if(!reads)
+		return;
+	for(uint i = 0; i < depth_; i++){
+		buf = reads[i].buf;
+
+		if(fixed.index(buf, 1) >= 0)
+			fixed.release(buf);
+		else
+			xe_dealloc(buf);
+		xe_destruct(&reads[i]);
+	}
+
+	xe_deallocp((xe_ptr&)reads);
+
+	depth_ = 0;
+	chunk_size_ = 0;
+	active_ = false;
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+#include "xstd/types.h"
+#include "xutil/util.h"
+#include "file.h"
+
+/*
+ * sequential O_DIRECT reader keeping depth aligned reads in flight
+ * chunks are delivered in file order
+ */
+class xe_file_reader{
+private:
+	class xe_read : public xe_req{
+	private:
+		static void complete(xe_req&, int, uint);
+
+		xe_file_reader* reader;
+		byte* buf;
+		int result;
+		bool inflight: 1;
+		bool done: 1;
+
+		friend class xe_file_reader;
+	public:
+		xe_read(){
+			event = complete;
+			reader = null;
+			buf = null;
+			result = 0;
+			inflight = false;
+			done = false;
+		}
+
+		~xe_read() = default;
+	};
+
+	static void open_callback(xe_open_req&, int);
+
+	int submit(xe_read&);
+	void deliver();
+	void end(int);
+
+	xe_file file_;
+	xe_open_req open_req;
+	xe_read* reads;
+
+	xe_cstr path;
+	long offset;
+
+	uint depth_;
+	uint chunk_size_;
+	uint head;
+	uint pending;
+	int result_;
+
+	bool active_: 1;
+	bool opening: 1;
+	bool ended: 1;
+	bool o_direct: 1;
+public:
+	/*
+	 * result > 0: buf holds result bytes, valid until the callback returns
+	 * result <= 0: the reader is idle, 0 for end of file
+	 */
+	typedef void (*xe_callback)(xe_file_reader& reader, int result, xe_ptr buf);
+
+	xe_callback callback;
+
+	xe_file_reader(xe_loop& loop): file_(loop){
+		open_req.callback = open_callback;
+		reads = null;
+		path = null;
+		offset = 0;
+
+		depth_ = 0;
+		chunk_size_ = 0;
+		head = 0;
+		pending = 0;
+		result_ = 0;
+
+		active_ = false;
+		opening = false;
+		ended = false;
+		o_direct = false;
+
+		callback = null;
+	}
+
+	xe_disable_copy_move(xe_file_reader)
+
+	/* chunk_size must be a multiple of 4096, buffers come from the loop's fixed buffers when it has them */
+	int init(uint depth, uint chunk_size);
+
+	/*
+	 * open path and read from offset, which must be 4096 aligned
+	 * falls back to buffered reads when the filesystem has no O_DIRECT
+	 * path must stay valid until the open completes
+	 */
+	int open(xe_cstr path, long offset = 0);
+
+	/* cancel the reads in flight, the callback gets XE_ECANCELED once they finish */
+	int stop();
+
+	/* only once the reader is idle */
+	void close();
+
+	xe_file& file(){
+		return file_;
+	}
+
+	uint depth() const{
+		return depth_;
+	}
+
+	uint chunk_size() const{
+		return chunk_size_;
+	}
+
+	bool active() const{
+		return active_;
+	}
+
+	~xe_file_reader(){
+		close();
+	}
+};
\ No newline at end of file
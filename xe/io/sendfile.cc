@@ -0,0 +1,156 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <limits.h>
+#include "sendfile.h"
+#include "../error.h"
+
+enum{
+	XE_SENDFILE_DEFAULT_PIPE_SIZE = 64 * 1024
+};
+
+void xe_sendfile::in_callback(xe_req& req, int res){
+	xe_sendfile& transfer = xe_containerof(req, &xe_sendfile::in_req);
+
+	transfer.pending--;
+
+	if(res < 0){
+		if(!transfer.error) transfer.error = res;
+	}else{
+		transfer.offset += res;
+		transfer.left -= res;
+		transfer.piped += res;
+
+		if(!res) transfer.eof = true;
+	}
+
+	if(!transfer.pending) transfer.next();
+}
+
+void xe_sendfile::out_callback(xe_req& req, int res){
+	xe_sendfile& transfer = xe_containerof(req, &xe_sendfile::out_req);
+
+	transfer.pending--;
+
+	if(res == XE_ECANCELED){
+		/* the file splice came up short and broke the link, the pipe is drained next round */
+	}else if(res <= 0){
+		if(!transfer.error) transfer.error = res ? res : XE_EPIPE;
+	}else{
+		transfer.piped -= res;
+		transfer.sent += res;
+	}
+
+	if(!transfer.pending) transfer.next();
+}
+
+int xe_sendfile::start(xe_socket& socket, xe_file& file, long offset_, size_t len){
+	int size;
+	int err;
+
+	if(active)
+		return XE_EALREADY;
+	if(!len || len > INT_MAX || offset_ < 0)
+		return XE_EINVAL;
+	if(pipe2(pipe, O_CLOEXEC) < 0)
+		return xe_errno();
+	/* a bigger pipe means fewer rounds */
+	size = fcntl(pipe[1], F_SETPIPE_SZ, XE_SENDFILE_PIPE_SIZE);
+
+	if(size < 0)
+		size = fcntl(pipe[1], F_GETPIPE_SZ);
+	loop = &socket.loop();
+	in_fd = file.fd();
+	out_fd = socket.fd();
+	in_flags = file.direct() ? SPLICE_F_FD_IN_FIXED : 0;
+	out_flags = socket.direct() ? IOSQE_FIXED_FILE : 0;
+
+	offset = offset_;
+	left = len;
+	sent = 0;
+	piped = 0;
+	pipe_size = size > 0 ? size : XE_SENDFILE_DEFAULT_PIPE_SIZE;
+	pending = 0;
+	error = 0;
+
+	eof = false;
+	active = true;
+
+	err = submit();
+
+	if(!err)
+		return 0;
+	active = false;
+
+	::close(pipe[0]);
+	::close(pipe[1]);
+
+	pipe[0] = -1;
+	pipe[1] = -1;
+
+	return err;
+}
+
+int xe_sendfile::submit(){
+	uint len;
+	uint more;
+
+	if(piped){
+		/* the socket took less than the file gave, drain the pipe first */
+		xe_return_error(loop -> run(out_req, xe_op::splice(pipe[0], -1, out_fd, -1, piped, SPLICE_F_MOVE).orflags(out_flags), &info[1]));
+
+		pending = 1;
+
+		return 0;
+	}
+
+	len = xe_min<size_t>(left, pipe_size);
+	more = left > len ? SPLICE_F_MORE : 0;
+
+	xe_return_error(loop -> chain()
+		.add(xe_op::splice(in_fd, offset, pipe[1], -1, len, SPLICE_F_MOVE | in_flags), in_req, &info[0])
+		.add(xe_op::splice(pipe[0], -1, out_fd, -1, len, SPLICE_F_MOVE | more).orflags(out_flags), out_req, &info[1])
+		.submit());
+	pending = 2;
+
+	return 0;
+}
+
+void xe_sendfile::next(){
+	int res = error;
+
+	if(!res && (piped || (left && !eof))){
+		res = submit();
+
+		if(!res) return;
+	}
+
+	finish(res ? res : sent);
+}
+
+void xe_sendfile::finish(int res){
+	active = false;
+
+	::close(pipe[0]);
+	::close(pipe[1]);
+
+	pipe[0] = -1;
+	pipe[1] = -1;
+
+	done(*this, res);
+}
+
+void xe_sendfile_req::complete(xe_sendfile& transfer, int res){
+	xe_sendfile_req& req = xe_containerof(transfer, &xe_sendfile_req::transfer);
+
+	if(req.callback) req.callback(req, res);
+}
+
+void xe_sendfile_promise::complete(xe_sendfile& transfer, int res){
+	xe_sendfile_promise& promise = xe_containerof(transfer, &xe_sendfile_promise::transfer);
+
+	xe_promise::complete(promise, res, 0);
+}
+
+xe_sendfile_promise::xe_sendfile_promise(){
+	transfer.done = complete;
+}
\ No newline at end of file
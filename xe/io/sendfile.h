@@ -0,0 +1,114 @@
+#pragma once
+#include "xstd/types.h"
+#include "xutil/util.h"
+#include "socket.h"
+#include "file.h"
+
+enum xe_sendfile_size{
+	XE_SENDFILE_PIPE_SIZE = 1024 * 1024 /* requested, the kernel may give less */
+};
+
+/*
+ * moves a file range to a socket through a pipe
+ * each round is a linked splice(file -> pipe), splice(pipe -> socket)
+ */
+class xe_sendfile{
+private:
+	static void in_callback(xe_req&, int);
+	static void out_callback(xe_req&, int);
+
+	int start(xe_socket&, xe_file&, long, size_t);
+	int submit();
+	void next();
+	void finish(int);
+
+	xe_loop* loop;
+	void (*done)(xe_sendfile&, int);
+
+	xe_req in_req;
+	xe_req out_req;
+	xe_req_info info[2];
+
+	int pipe[2];
+	int in_fd;
+	int out_fd;
+	uint in_flags; /* SPLICE_F_FD_IN_FIXED for direct files */
+	byte out_flags; /* IOSQE_FIXED_FILE for direct sockets */
+
+	long offset;
+	size_t left;
+	size_t sent;
+	uint piped; /* bytes sitting in the pipe */
+	uint pipe_size;
+	uint pending;
+	int error;
+
+	bool eof: 1;
+	bool active: 1;
+
+	friend class xe_socket;
+	friend class xe_sendfile_req;
+	friend class xe_sendfile_promise;
+public:
+	xe_sendfile(){
+		in_req.callback = in_callback;
+		out_req.callback = out_callback;
+
+		pipe[0] = -1;
+		pipe[1] = -1;
+		active = false;
+	}
+
+	/* only moved before it starts, with a returned promise */
+	xe_sendfile(xe_sendfile&& other): xe_sendfile(){
+		loop = other.loop;
+		done = other.done;
+		active = other.active;
+	}
+
+	xe_disable_copy(xe_sendfile)
+	xe_disable_move_assign(xe_sendfile)
+
+	~xe_sendfile() = default;
+};
+
+class xe_sendfile_req{
+private:
+	static void complete(xe_sendfile&, int);
+
+	xe_sendfile transfer;
+
+	friend class xe_socket;
+public:
+	/* result: bytes sent, less than requested at the end of the file */
+	typedef void (*xe_callback)(xe_sendfile_req& req, int result);
+
+	xe_callback callback;
+
+	xe_sendfile_req(xe_callback cb = null){
+		transfer.done = complete;
+		callback = cb;
+	}
+
+	xe_disable_copy_move(xe_sendfile_req)
+
+	bool active() const{
+		return transfer.active;
+	}
+
+	~xe_sendfile_req() = default;
+};
+
+class xe_sendfile_promise : public xe_promise{
+private:
+	static void complete(xe_sendfile&, int);
+
+	xe_sendfile transfer;
+
+	xe_sendfile_promise();
+	xe_sendfile_promise(xe_sendfile_promise&&) = default;
+
+	friend class xe_socket;
+public:
+	~xe_sendfile_promise() = default;
+};
\ No newline at end of file
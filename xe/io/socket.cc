@@ -1,5 +1,6 @@
 #include <unistd.h>
 #include "socket.h"
+#include "sendfile.h"
 #include "../error.h"
 
 enum xe_socket_state{
@@ -59,12 +60,290 @@ xe_connect_promise::xe_connect_promise(){
 	event = complete;
 }
 
+/*
+ * buffers from the loop's fixed buffer slab skip page pinning,
+ * the _fixed ops take no msg flags so only plain transfers use them
+ */
+static inline xe_op xe_socket_recv_op(xe_loop& loop, int fd, xe_ptr buf, uint len, uint flags){
+	int index = flags ? -1 : loop.fixed_buffers().index(buf, len);
+
+	return index < 0 ? xe_op::recv(fd, buf, len, flags) : xe_op::read_fixed(fd, buf, len, 0, index);
+}
+
+static inline xe_op xe_socket_send_op(xe_loop& loop, int fd, xe_cptr buf, uint len, uint flags){
+	int index = flags ? -1 : loop.fixed_buffers().index(buf, len);
+
+	return index < 0 ? xe_op::send(fd, buf, len, flags) : xe_op::write_fixed(fd, buf, len, 0, index);
+}
+
+static inline xe_op xe_socket_send_zc_op(xe_loop& loop, int fd, xe_cptr buf, uint len, uint flags){
+	int index;
+
+	if(len < XE_SEND_ZC_MIN)
+		return xe_op::send(fd, buf, len, flags);
+	index = loop.fixed_buffers().index(buf, len);
+
+	if(index < 0)
+		return xe_op::send_zc(fd, buf, len, flags);
+	return xe_op::send_zc(fd, buf, len, flags, index).recvsend_fixed_buf();
+}
+
+void xe_send_zc_req::complete(xe_req& req, int res, uint flags){
+	xe_send_zc_req& zc_req = (xe_send_zc_req&)req;
+
+	if(flags & IORING_CQE_F_NOTIF){
+		if(zc_req.release) zc_req.release(zc_req);
+
+		return;
+	}
+
+	if(zc_req.callback) zc_req.callback(zc_req, res);
+
+	/* copied, failed, or nothing to pin */
+	if(!(flags & IORING_CQE_F_MORE) && zc_req.release)
+		zc_req.release(zc_req);
+}
+
+void xe_send_zc_promise::complete(xe_req& req, int res, uint flags){
+	xe_send_zc_promise& promise = (xe_send_zc_promise&)req;
+	xe_coroutine_handle handle;
+
+	if(flags & IORING_CQE_F_NOTIF){
+		promise.released = true;
+	}else{
+		promise.result_ = res;
+		promise.ready_ = true;
+		promise.released = !(flags & IORING_CQE_F_MORE);
+	}
+
+	/* the notification may still follow, resuming now would free the promise under it */
+	if(!promise.ready_ || !promise.released || !promise.waiter)
+		return;
+	handle = promise.waiter;
+	promise.waiter = null;
+	handle.resume();
+}
+
+xe_send_zc_promise::xe_send_zc_promise(){
+	event = complete;
+	released = false;
+}
+
+/* completion target for cancels nobody waits on */
+static xe_req xe_socket_cancel_req;
+
+void xe_recv_multishot_req::complete(xe_req& req, int res, uint flags){
+	xe_socket::multishot_complete((xe_recv_multishot_req&)req, res, flags);
+}
+
+void xe_recv_multishot_req::buffer_ready(xe_buffer_waiter& waiter){
+	xe_socket::multishot_resume(xe_containerof(waiter, &xe_recv_multishot_req::buffer_waiter));
+}
+
+void xe_recv_multishot_req::ended(xe_loop& loop, xe_hook& hook){
+	xe_socket::multishot_end(xe_containerof(hook, &xe_recv_multishot_req::end_hook));
+}
+
+void xe_recv_multishot_req::deliver(int res, uint flags){
+	xe_ptr buf = null;
+
+	if(flags & IORING_CQE_F_BUFFER){
+		buffer_id_ = xe_buffer_ring::buffer_id(flags);
+		buf = ring -> take(buffer_id_);
+	}
+
+	if(callback) callback(*this, res, buf);
+}
+
+void xe_recv_multishot_promise::complete(xe_req& req, int res, uint flags){
+	xe_socket::multishot_complete((xe_recv_multishot_promise&)req, res, flags);
+}
+
+void xe_recv_multishot_promise::buffer_ready(xe_buffer_waiter& waiter){
+	xe_socket::multishot_resume(xe_containerof(waiter, &xe_recv_multishot_promise::buffer_waiter));
+}
+
+void xe_recv_multishot_promise::ended(xe_loop& loop, xe_hook& hook){
+	xe_socket::multishot_end(xe_containerof(hook, &xe_recv_multishot_promise::end_hook));
+}
+
+void xe_recv_multishot_promise::deliver(int res, uint flags){
+	xe_coroutine_handle handle;
+	ushort bid;
+
+	if(flags & IORING_CQE_F_BUFFER){
+		bid = xe_buffer_ring::buffer_id(flags);
+		ring -> take(bid);
+	}
+
+	if(!pending.push_back({ res, flags })) [[unlikely]] {
+		/* nowhere to put the result, drop it and end the stream */
+		if(flags & IORING_CQE_F_BUFFER)
+			ring -> recycle(bid);
+		if(!error)
+			error = res <= 0 ? res : XE_ENOMEM;
+		if(active_) socket -> multishot_cancel(*this);
+	}
+
+	if(!waiter)
+		return;
+	handle = waiter;
+	waiter = null;
+	handle.resume();
+}
+
+xe_recv_multishot_promise::xe_recv_multishot_promise(){
+	event = complete;
+	buffer_waiter.callback = buffer_ready;
+	end_hook.callback = ended;
+
+	socket = null;
+	ring = null;
+	head = 0;
+	error = 0;
+	end_result = 0;
+	msg_flags = 0;
+	active_ = false;
+	armed = false;
+}
+
+xe_recv_multishot_promise::xe_recv_multishot_promise(xe_recv_multishot_promise&& other): xe_promise(std::move(other)), pending(std::move(other.pending)){
+	/* promises are only moved when returned, before any completion arrives */
+	buffer_waiter.callback = buffer_ready;
+	end_hook.callback = ended;
+
+	socket = other.socket;
+	ring = other.ring;
+	head = other.head;
+	error = other.error;
+	end_result = other.end_result;
+	msg_flags = other.msg_flags;
+	active_ = other.active_;
+	armed = other.armed;
+}
+
+int xe_recv_multishot_promise::await_resume(){
+	if(head == pending.size()){
+		/* only reached on error */
+		result_ = error;
+		flags_ = 0;
+
+		return result_;
+	}
+
+	xe_completion& completion = pending[head++];
+
+	flags_ = completion.flags;
+	result_ = completion.result;
+	ready_ = true;
+
+	if(head == pending.size()){
+		pending.resize(0);
+		head = 0;
+	}
+
+	return result_;
+}
+
+template<class xe_multishot>
+void xe_socket::multishot_complete(xe_multishot& req, int res, uint flags){
+	if(!(flags & IORING_CQE_F_MORE)){
+		req.armed = false;
+
+		if(!req.active_){
+			/* last completion after a cancel */
+		}else if(res > 0){
+			/* the kernel dropped the multishot, start it again */
+			int err = req.socket -> multishot_arm(req);
+
+			if(err == XE_ENOBUFS){
+				/* retry once a buffer is recycled, the one delivered below included */
+				req.ring -> wait(req.buffer_waiter);
+			}else if(err){
+				/* the stream has ended, report why after the data below */
+				req.active_ = false;
+				req.end_result = err;
+				req.socket -> loop_ -> check(req.end_hook);
+			}
+		}else if(res == XE_ENOBUFS){
+			/* ran out of buffers, resume once one is recycled */
+			if(!req.ring -> available()){
+				req.ring -> wait(req.buffer_waiter);
+
+				return;
+			}
+
+			res = req.socket -> multishot_arm(req);
+
+			if(!res) return;
+		}
+
+		if(res <= 0)
+			req.active_ = false;
+	}
+
+	req.deliver(res, flags);
+}
+
+template<class xe_multishot>
+void xe_socket::multishot_resume(xe_multishot& req){
+	int err = req.socket -> multishot_arm(req);
+
+	if(err){
+		req.active_ = false;
+		req.deliver(err, 0);
+	}
+}
+
+template<class xe_multishot>
+void xe_socket::multishot_end(xe_multishot& req){
+	req.socket -> loop_ -> cancel(req.end_hook);
+	req.deliver(req.end_result, 0);
+}
+
+template<class xe_multishot>
+int xe_socket::multishot_arm(xe_multishot& req){
+	xe_return_error(loop_ -> run(req, io(xe_op::recv(fd_, null, 0, req.msg_flags).buffer_select(req.ring -> id()).recv_multishot())));
+
+	req.armed = true;
+
+	return 0;
+}
+
+template<class xe_multishot>
+int xe_socket::multishot_cancel(xe_multishot& req){
+	int res;
+
+	if(!req.active_){
+		/* drop an end result not yet delivered */
+		if(req.end_hook.active())
+			loop_ -> cancel(req.end_hook);
+		return req.armed ? XE_EALREADY : 0;
+	}
+
+	req.active_ = false;
+
+	if(req.buffer_waiter.waiting()){
+		/* not armed, nothing left to stop */
+		req.buffer_waiter.cancel();
+
+		return 0;
+	}
+
+	res = loop_ -> cancel(xe_socket_cancel_req, req, xe_op::cancel(0));
+
+	if(res != XE_EINPROGRESS)
+		req.active_ = true;
+	return res;
+}
+
 void xe_socket::open(int res){
 	if(res >= 0){
 		fd_ = res;
 		state = XE_SOCKET_READY;
 	}else{
 		state = XE_SOCKET_NONE;
+		direct_ = false;
 	}
 }
 
@@ -102,15 +381,24 @@ int xe_socket::accept(int fd){
 	return 0;
 }
 
+int xe_socket::accept_direct(uint index){
+	xe_return_error(accept(index));
+
+	direct_ = true;
+
+	return 0;
+}
+
 int xe_socket::init(xe_socket_req& req, int af, int type, int proto){
 	if(state == XE_SOCKET_OPENING)
 		return XE_EALREADY;
 	if(state != XE_SOCKET_NONE)
 		return XE_STATE;
-	xe_return_error(loop_ -> run(req, xe_op::socket(af, type, proto, 0)));
+	xe_return_error(loop_ -> run(req, xe_op::socket(af, type, proto, 0, direct_index())));
 
 	req.socket = this;
 	state = XE_SOCKET_OPENING;
+	direct_ = loop_ -> direct_files() != 0;
 
 	return 0;
 }
@@ -124,26 +412,29 @@ xe_socket_promise xe_socket::init(int af, int type, int proto){
 	else if(state != XE_SOCKET_NONE)
 		res = XE_STATE;
 	else
-		res = loop_ -> run(promise, xe_op::socket(af, type, proto, 0));
+		res = loop_ -> run(promise, xe_op::socket(af, type, proto, 0, direct_index()));
 	if(res){
 		promise.result_ = res;
 		promise.ready_ = true;
 	}else{
 		promise.socket = this;
 		state = XE_SOCKET_OPENING;
+		direct_ = loop_ -> direct_files() != 0;
 	}
 
 	return promise;
 }
 
 int xe_socket::accept_sync(sockaddr* addr, socklen_t* addrlen, uint flags){
+	if(direct_)
+		return XE_STATE;
 	int fd = accept4(fd_, addr, addrlen, flags);
 
 	return fd < 0 ? xe_errno() : fd;
 }
 
 int xe_socket::connect_sync(const sockaddr* addr, socklen_t addrlen){
-	if(state != XE_SOCKET_READY && state != XE_SOCKET_CONNECTED)
+	if(direct_ || (state != XE_SOCKET_READY && state != XE_SOCKET_CONNECTED))
 		return XE_STATE;
 	if(::connect(fd_, addr, addrlen) < 0)
 		return xe_errno();
@@ -155,7 +446,7 @@ int xe_socket::connect_sync(const sockaddr* addr, socklen_t addrlen){
 int xe_socket::accept(xe_req& req, sockaddr* addr, socklen_t* addrlen, uint flags){
 	if(state != XE_SOCKET_LISTENING)
 		return XE_STATE;
-	return loop_ -> run(req, xe_op::accept(fd_, addr, addrlen, flags));
+	return loop_ -> run(req, io(xe_op::accept(fd_, addr, addrlen, flags)));
 }
 
 int xe_socket::connect(xe_connect_req& req, const sockaddr* addr, socklen_t addrlen){
@@ -163,7 +454,7 @@ int xe_socket::connect(xe_connect_req& req, const sockaddr* addr, socklen_t addr
 		return XE_EALREADY;
 	if(state != XE_SOCKET_READY)
 		return XE_STATE;
-	xe_return_error(loop_ -> run(req, xe_op::connect(fd_, addr, addrlen)));
+	xe_return_error(loop_ -> run(req, io(xe_op::connect(fd_, addr, addrlen))));
 
 	req.socket = this;
 	state = XE_SOCKET_CONNECTING;
@@ -174,7 +465,19 @@ int xe_socket::connect(xe_connect_req& req, const sockaddr* addr, socklen_t addr
 xe_promise xe_socket::accept(sockaddr* addr, socklen_t* addrlen, uint flags){
 	if(state != XE_SOCKET_LISTENING)
 		return xe_promise::done(XE_STATE);
-	return loop_ -> run(xe_op::accept(fd_, addr, addrlen, flags));
+	return loop_ -> run(io(xe_op::accept(fd_, addr, addrlen, flags)));
+}
+
+int xe_socket::accept_direct(xe_req& req, sockaddr* addr, socklen_t* addrlen, uint flags){
+	if(state != XE_SOCKET_LISTENING || !loop_ -> direct_files())
+		return XE_STATE;
+	return loop_ -> run(req, io(xe_op::accept(fd_, addr, addrlen, flags, IORING_FILE_INDEX_ALLOC)));
+}
+
+xe_promise xe_socket::accept_direct(sockaddr* addr, socklen_t* addrlen, uint flags){
+	if(state != XE_SOCKET_LISTENING || !loop_ -> direct_files())
+		return xe_promise::done(XE_STATE);
+	return loop_ -> run(io(xe_op::accept(fd_, addr, addrlen, flags, IORING_FILE_INDEX_ALLOC)));
 }
 
 xe_connect_promise xe_socket::connect(const sockaddr* addr, socklen_t addrlen){
@@ -186,7 +489,7 @@ xe_connect_promise xe_socket::connect(const sockaddr* addr, socklen_t addrlen){
 	else if(state != XE_SOCKET_READY)
 		res = XE_STATE;
 	else
-		res = loop_ -> run(promise, xe_op::connect(fd_, addr, addrlen));
+		res = loop_ -> run(promise, io(xe_op::connect(fd_, addr, addrlen)));
 	if(res){
 		promise.result_ = res;
 		promise.ready_ = true;
@@ -201,6 +504,8 @@ xe_connect_promise xe_socket::connect(const sockaddr* addr, socklen_t addrlen){
 int xe_socket::recv_sync(xe_ptr buf, uint len, uint flags){
 	if(state != XE_SOCKET_CONNECTED)
 		return XE_ENOTCONN;
+	if(direct_)
+		return XE_STATE;
 	int recvd = ::recv(fd_, buf, len, flags);
 
 	return recvd < 0 ? xe_errno() : recvd;
@@ -209,6 +514,8 @@ int xe_socket::recv_sync(xe_ptr buf, uint len, uint flags){
 int xe_socket::send_sync(xe_cptr buf, uint len, uint flags){
 	if(state != XE_SOCKET_CONNECTED)
 		return XE_ENOTCONN;
+	if(direct_)
+		return XE_STATE;
 	int sent = ::send(fd_, buf, len, flags);
 
 	return sent < 0 ? xe_errno() : sent;
@@ -217,30 +524,117 @@ int xe_socket::send_sync(xe_cptr buf, uint len, uint flags){
 int xe_socket::recv(xe_req& req, xe_ptr buf, uint len, uint flags){
 	if(state != XE_SOCKET_CONNECTED)
 		return XE_ENOTCONN;
-	return loop_ -> run(req, xe_op::recv(fd_, buf, len, flags));
+	return loop_ -> run(req, io(xe_socket_recv_op(*loop_, fd_, buf, len, flags)));
 }
 
 int xe_socket::send(xe_req& req, xe_cptr buf, uint len, uint flags){
 	if(state != XE_SOCKET_CONNECTED)
 		return XE_ENOTCONN;
-	return loop_ -> run(req, xe_op::send(fd_, buf, len, flags));
+	return loop_ -> run(req, io(xe_socket_send_op(*loop_, fd_, buf, len, flags)));
 }
 
 xe_promise xe_socket::recv(xe_ptr buf, uint len, uint flags){
 	if(state != XE_SOCKET_CONNECTED)
 		return xe_promise::done(XE_ENOTCONN);
-	return loop_ -> run(xe_op::recv(fd_, buf, len, flags));
+	return loop_ -> run(io(xe_socket_recv_op(*loop_, fd_, buf, len, flags)));
 }
 
 xe_promise xe_socket::send(xe_cptr buf, uint len, uint flags){
 	if(state != XE_SOCKET_CONNECTED)
 		return xe_promise::done(XE_ENOTCONN);
-	return loop_ -> run(xe_op::send(fd_, buf, len, flags));
+	return loop_ -> run(io(xe_socket_send_op(*loop_, fd_, buf, len, flags)));
+}
+
+int xe_socket::send_zc(xe_send_zc_req& req, xe_cptr buf, uint len, uint flags){
+	if(state != XE_SOCKET_CONNECTED)
+		return XE_ENOTCONN;
+	return loop_ -> run(req, io(xe_socket_send_zc_op(*loop_, fd_, buf, len, flags)));
+}
+
+xe_send_zc_promise xe_socket::send_zc(xe_cptr buf, uint len, uint flags){
+	xe_send_zc_promise promise;
+	int res;
+
+	if(state != XE_SOCKET_CONNECTED)
+		res = XE_ENOTCONN;
+	else
+		res = loop_ -> run(promise, io(xe_socket_send_zc_op(*loop_, fd_, buf, len, flags)));
+	if(res){
+		promise.result_ = res;
+		promise.ready_ = true;
+		promise.released = true;
+	}
+
+	return promise;
+}
+
+int xe_socket::sendfile(xe_sendfile_req& req, xe_file& file, long offset, size_t len){
+	if(state != XE_SOCKET_CONNECTED)
+		return XE_ENOTCONN;
+	return req.transfer.start(*this, file, offset, len);
+}
+
+xe_sendfile_promise xe_socket::sendfile(xe_file& file, long offset, size_t len){
+	xe_sendfile_promise promise;
+	int res;
+
+	if(state != XE_SOCKET_CONNECTED)
+		res = XE_ENOTCONN;
+	else
+		res = promise.transfer.start(*this, file, offset, len);
+	if(res){
+		promise.result_ = res;
+		promise.ready_ = true;
+	}
+
+	return promise;
+}
+
+int xe_socket::recv_multishot(xe_recv_multishot_req& req, xe_buffer_ring& ring, uint flags){
+	if(state != XE_SOCKET_CONNECTED)
+		return XE_ENOTCONN;
+	if(req.active_ || req.armed || req.end_hook.active())
+		return XE_EALREADY;
+	req.socket = this;
+	req.ring = &ring;
+	req.msg_flags = flags;
+
+	xe_return_error(multishot_arm(req));
+
+	req.active_ = true;
+
+	return 0;
+}
+
+xe_recv_multishot_promise xe_socket::recv_multishot(xe_buffer_ring& ring, uint flags){
+	xe_recv_multishot_promise promise;
+
+	promise.socket = this;
+	promise.ring = &ring;
+	promise.msg_flags = flags;
+
+	if(state != XE_SOCKET_CONNECTED)
+		promise.error = XE_ENOTCONN;
+	else
+		promise.error = multishot_arm(promise);
+	if(!promise.error)
+		promise.active_ = true;
+	return promise;
+}
+
+int xe_socket::recv_multishot_cancel(xe_recv_multishot_req& req){
+	return multishot_cancel(req);
+}
+
+int xe_socket::recv_multishot_cancel(xe_recv_multishot_promise& promise){
+	return multishot_cancel(promise);
 }
 
 int xe_socket::recvmsg_sync(msghdr* msg, uint flags){
 	if(state != XE_SOCKET_CONNECTED)
 		return XE_ENOTCONN;
+	if(direct_)
+		return XE_STATE;
 	int recvd = ::recvmsg(fd_, msg, flags);
 
 	return recvd < 0 ? xe_errno() : recvd;
@@ -249,6 +643,8 @@ int xe_socket::recvmsg_sync(msghdr* msg, uint flags){
 int xe_socket::sendmsg_sync(const msghdr* msg, uint flags){
 	if(state != XE_SOCKET_CONNECTED)
 		return XE_ENOTCONN;
+	if(direct_)
+		return XE_STATE;
 	int sent = ::sendmsg(fd_, msg, flags);
 
 	return sent < 0 ? xe_errno() : sent;
@@ -257,53 +653,55 @@ int xe_socket::sendmsg_sync(const msghdr* msg, uint flags){
 int xe_socket::recvmsg(xe_req& req, msghdr* msg, uint flags){
 	if(state != XE_SOCKET_CONNECTED)
 		return XE_ENOTCONN;
-	return loop_ -> run(req, xe_op::recvmsg(fd_, msg, flags));
+	return loop_ -> run(req, io(xe_op::recvmsg(fd_, msg, flags)));
 }
 
 int xe_socket::sendmsg(xe_req& req, const msghdr* msg, uint flags){
 	if(state != XE_SOCKET_CONNECTED)
 		return XE_ENOTCONN;
-	return loop_ -> run(req, xe_op::sendmsg(fd_, msg, flags));
+	return loop_ -> run(req, io(xe_op::sendmsg(fd_, msg, flags)));
 }
 
 xe_promise xe_socket::recvmsg(msghdr* msg, uint flags){
 	if(state != XE_SOCKET_CONNECTED)
 		return xe_promise::done(XE_ENOTCONN);
-	return loop_ -> run(xe_op::recvmsg(fd_, msg, flags));
+	return loop_ -> run(io(xe_op::recvmsg(fd_, msg, flags)));
 }
 
 xe_promise xe_socket::sendmsg(const msghdr* msg, uint flags){
 	if(state != XE_SOCKET_CONNECTED)
 		return xe_promise::done(XE_ENOTCONN);
-	return loop_ -> run(xe_op::sendmsg(fd_, msg, flags));
+	return loop_ -> run(io(xe_op::sendmsg(fd_, msg, flags)));
 }
 
 int xe_socket::shutdown_sync(int how){
 	if(state != XE_SOCKET_CONNECTED)
 		return XE_ENOTCONN;
+	if(direct_)
+		return XE_STATE;
 	return ::shutdown(fd_, how) < 0 ? xe_errno() : 0;
 }
 
 int xe_socket::shutdown(xe_req& req, int how){
 	if(state != XE_SOCKET_CONNECTED)
 		return XE_ENOTCONN;
-	return loop_ -> run(req, xe_op::shutdown(fd_, how));
+	return loop_ -> run(req, io(xe_op::shutdown(fd_, how)));
 }
 
 xe_promise xe_socket::shutdown(int how){
 	if(state != XE_SOCKET_CONNECTED)
 		return xe_promise::done(XE_ENOTCONN);
-	return loop_ -> run(xe_op::shutdown(fd_, how));
+	return loop_ -> run(io(xe_op::shutdown(fd_, how)));
 }
 
 int xe_socket::bind(sockaddr* addr, socklen_t addrlen){
-	if(state != XE_SOCKET_READY)
+	if(state != XE_SOCKET_READY || direct_)
 		return XE_STATE;
 	return ::bind(fd_, addr, addrlen) < 0 ? xe_errno() : 0;
 }
 
 int xe_socket::listen(int maxqueuesize){
-	if(state != XE_SOCKET_READY)
+	if(state != XE_SOCKET_READY || direct_)
 		return XE_STATE;
 	if(::listen(fd_, maxqueuesize) < 0)
 		return xe_errno();
@@ -312,11 +710,25 @@ int xe_socket::listen(int maxqueuesize){
 	return 0;
 }
 
+int xe_socket::napi_id() const{
+	uint id = 0;
+	socklen_t len = sizeof(id);
+
+	if(fd_ < 0 || direct_)
+		return XE_STATE;
+	if(getsockopt(fd_, SOL_SOCKET, SO_INCOMING_NAPI_ID, &id, &len) < 0)
+		return xe_errno();
+	return id;
+}
+
 void xe_socket::close(){
 	if(fd_ >= 0){
-		::close(fd_);
-
+		if(direct_)
+			loop_ -> close_direct(fd_);
+		else
+			::close(fd_);
 		fd_ = -1;
 		state = XE_SOCKET_NONE;
+		direct_ = false;
 	}
 }
\ No newline at end of file
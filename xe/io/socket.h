@@ -1,10 +1,20 @@
 #pragma once
 #include <netdb.h>
 #include "xstd/types.h"
+#include "xstd/vector.h"
 #include "xutil/util.h"
 #include "../loop.h"
+#include "../buffer.h"
+
+enum xe_send_zc_size{
+	/* smaller zero copy sends are copied, pinning pages costs more than the copy */
+	XE_SEND_ZC_MIN = 16 * 1024
+};
 
 class xe_socket;
+class xe_file;
+class xe_sendfile_req;
+class xe_sendfile_promise;
 class xe_socket_req : public xe_req{
 private:
 	static void complete(xe_req&, int, uint);
@@ -75,24 +85,211 @@ public:
 	~xe_connect_promise() = default;
 };
 
+class xe_send_zc_req : public xe_req{
+private:
+	static void complete(xe_req&, int, uint);
+
+	friend class xe_socket;
+public:
+	typedef void (*xe_callback)(xe_send_zc_req& req, int result);
+	typedef void (*xe_release_callback)(xe_send_zc_req& req);
+
+	/* the send result */
+	xe_callback callback;
+	/* the buffer may be reused, always after callback */
+	xe_release_callback release;
+
+	xe_send_zc_req(xe_callback cb, xe_release_callback rel){
+		event = complete;
+		callback = cb;
+		release = rel;
+	}
+
+	xe_send_zc_req(): xe_send_zc_req(null, null){}
+
+	~xe_send_zc_req() = default;
+};
+
+/*
+ * resumes with the send result once the buffer is released,
+ * the kernel is done with the promise by then
+ */
+class xe_send_zc_promise : public xe_promise{
+private:
+	static void complete(xe_req&, int, uint);
+
+	bool released;
+
+	xe_send_zc_promise();
+	xe_send_zc_promise(xe_send_zc_promise&&) = default;
+
+	friend class xe_socket;
+public:
+	bool await_ready() const{
+		return ready_ && released;
+	}
+
+	int await_resume(){
+		return result_;
+	}
+
+	~xe_send_zc_promise() = default;
+};
+
+class xe_recv_multishot_req : public xe_req{
+private:
+	static void complete(xe_req&, int, uint);
+	static void buffer_ready(xe_buffer_waiter&);
+	static void ended(xe_loop&, xe_hook&);
+
+	void deliver(int, uint);
+
+	xe_socket* socket;
+	xe_buffer_ring* ring;
+	xe_buffer_waiter buffer_waiter;
+	xe_hook end_hook; /* delivers end_result after the data it arrived with */
+
+	int end_result;
+	uint msg_flags;
+	ushort buffer_id_;
+	bool active_: 1;
+	bool armed: 1;
+
+	friend class xe_socket;
+public:
+	/*
+	 * result > 0: buf holds result bytes, give it back with ring.recycle(buf)
+	 * result <= 0: the stream has ended
+	 */
+	typedef void (*xe_callback)(xe_recv_multishot_req& req, int result, xe_ptr buf);
+
+	xe_callback callback;
+
+	xe_recv_multishot_req(xe_callback cb){
+		event = complete;
+		callback = cb;
+		buffer_waiter.callback = buffer_ready;
+		end_hook.callback = ended;
+
+		socket = null;
+		ring = null;
+		end_result = 0;
+		msg_flags = 0;
+		buffer_id_ = 0;
+		active_ = false;
+		armed = false;
+	}
+
+	xe_recv_multishot_req(): xe_recv_multishot_req(null){}
+
+	xe_disable_copy_move(xe_recv_multishot_req)
+
+	bool active() const{
+		return active_;
+	}
+
+	ushort buffer_id() const{
+		return buffer_id_;
+	}
+
+	~xe_recv_multishot_req() = default;
+};
+
+class xe_recv_multishot_promise : public xe_promise{
+private:
+	static void complete(xe_req&, int, uint);
+	static void buffer_ready(xe_buffer_waiter&);
+	static void ended(xe_loop&, xe_hook&);
+
+	struct xe_completion{
+		int result;
+		uint flags;
+	};
+
+	void deliver(int, uint);
+
+	xe_socket* socket;
+	xe_buffer_ring* ring;
+	xe_buffer_waiter buffer_waiter;
+	xe_hook end_hook;
+
+	xe_vector<xe_completion> pending;
+	size_t head;
+	int error;
+	int end_result;
+
+	uint msg_flags;
+	bool active_: 1;
+	bool armed: 1;
+
+	xe_recv_multishot_promise();
+	xe_recv_multishot_promise(xe_recv_multishot_promise&&);
+
+	friend class xe_socket;
+public:
+	bool await_ready() const{
+		return head < pending.size() || error;
+	}
+
+	void await_suspend(xe_coroutine_handle handle){
+		waiter = handle;
+	}
+
+	int await_resume();
+
+	bool active() const{
+		return active_;
+	}
+
+	/* the buffer holding the data of the last awaited result */
+	xe_ptr buffer() const{
+		return has_buffer() ? ring -> buffer(buffer_id_) : null;
+	}
+
+	~xe_recv_multishot_promise() = default;
+};
+
 class xe_socket{
 private:
 	void open(int);
 	void connect(int);
 
+	template<class xe_multishot>
+	static void multishot_complete(xe_multishot&, int, uint);
+	template<class xe_multishot>
+	static void multishot_resume(xe_multishot&);
+	template<class xe_multishot>
+	static void multishot_end(xe_multishot&);
+	template<class xe_multishot>
+	int multishot_arm(xe_multishot&);
+	template<class xe_multishot>
+	int multishot_cancel(xe_multishot&);
+
+	xe_op io(xe_op op) const{
+		return direct_ ? op.orflags(IOSQE_FIXED_FILE) : op;
+	}
+
+	uint direct_index() const{
+		return loop_ -> direct_files() ? IORING_FILE_INDEX_ALLOC : 0;
+	}
+
 	xe_loop* loop_;
 
 	int fd_;
 	uint state;
+	bool direct_;
 
 	friend class xe_socket_req;
 	friend class xe_socket_promise;
 	friend class xe_connect_req;
 	friend class xe_connect_promise;
+	friend class xe_recv_multishot_req;
+	friend class xe_recv_multishot_promise;
 public:
 	xe_socket(){
 		fd_ = -1;
 		state = 0;
+		direct_ = false;
 	}
 
 	xe_socket(xe_loop& loop): xe_socket(){
@@ -113,10 +310,20 @@ public:
 		return fd_;
 	}
 
+	/* fd() is an index in the loop's direct descriptor table */
+	bool direct() const{
+		return direct_;
+	}
+
 	int init_sync(int af, int type, int proto);
 	int init_fd(int fd);
 	int accept(int fd);
+	int accept_direct(uint index);
 
+	/*
+	 * when the loop has a direct descriptor table the socket is opened into it,
+	 * direct sockets only support async operations
+	 */
 	int init(xe_socket_req& req, int af, int type, int proto);
 	xe_socket_promise init(int af, int type, int proto);
 
@@ -129,6 +336,10 @@ public:
 	xe_promise accept(sockaddr* addr, socklen_t* addrlen, uint flags);
 	xe_connect_promise connect(const sockaddr* addr, socklen_t addrlen);
 
+	/* accept into a free slot of the loop's direct descriptor table, the result is the index */
+	int accept_direct(xe_req& req, sockaddr* addr, socklen_t* addrlen, uint flags);
+	xe_promise accept_direct(sockaddr* addr, socklen_t* addrlen, uint flags);
+
 	int recv_sync(xe_ptr buf, uint len, uint flags);
 	int send_sync(xe_cptr buf, uint len, uint flags);
 
@@ -138,6 +349,24 @@ public:
 	xe_promise recv(xe_ptr buf, uint len, uint flags);
 	xe_promise send(xe_cptr buf, uint len, uint flags);
 
+	/* send without copying buf, which must stay untouched until released */
+	int send_zc(xe_send_zc_req& req, xe_cptr buf, uint len, uint flags);
+	xe_send_zc_promise send_zc(xe_cptr buf, uint len, uint flags);
+
+	/* send len bytes of file from offset through a pipe, never copying them to userspace, see sendfile.h */
+	int sendfile(xe_sendfile_req& req, xe_file& file, long offset, size_t len);
+	xe_sendfile_promise sendfile(xe_file& file, long offset, size_t len);
+
+	/*
+	 * keep a multishot recv armed, each completion picks a buffer from ring
+	 * re-armed automatically when the kernel drops the multishot
+	 */
+	int recv_multishot(xe_recv_multishot_req& req, xe_buffer_ring& ring, uint flags);
+	xe_recv_multishot_promise recv_multishot(xe_buffer_ring& ring, uint flags);
+
+	int recv_multishot_cancel(xe_recv_multishot_req& req);
+	int recv_multishot_cancel(xe_recv_multishot_promise& promise);
+
 	int recvmsg_sync(msghdr* msg, uint flags);
 	int sendmsg_sync(const msghdr* msg, uint flags);
 
@@ -154,6 +383,9 @@ public:
 	int bind(sockaddr* addr, socklen_t addrlen);
 	int listen(int maxqueuesize);
 
+	/* id of the nic queue the socket's packets arrive on, 0 if unknown. see xe_loop_options::napi_busy_poll_us */
+	int napi_id() const;
+
 	void close();
 
 	~xe_socket() = default;
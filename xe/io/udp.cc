@@ -0,0 +1,269 @@
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include "xutil/mem.h"
+#include "udp.h"
+#include "../error.h"
+
+/* completion target for cancels nobody waits on */
+static xe_req xe_udp_cancel_req;
+
+void xe_udp_send_req::complete(xe_req& req, int res, uint flags){
+	xe_udp_send_req& send = (xe_udp_send_req&)req;
+
+	if(send.callback) send.callback(send, res);
+}
+
+void xe_udp::recv_complete(xe_req& req, int res, uint flags){
+	xe_udp& udp = xe_containerof(req, &xe_udp::recv_req);
+
+	if(flags & IORING_CQE_F_BUFFER)
+		udp.received(res, flags);
+	if(flags & IORING_CQE_F_MORE) [[likely]]
+		return;
+	udp.armed = false;
+
+	if(!udp.active_){
+		/* last completion after a stop, the recvmsg is released */
+		if(udp.close_callback) udp.close_callback(udp);
+
+		return;
+	}
+
+	if(res >= 0){
+		/* the kernel dropped the multishot, start it again */
+		res = udp.arm();
+	}else if(res == XE_ENOBUFS){
+		/* buffers come back when the batch is delivered */
+		if(!udp.ring -> available()){
+			udp.ring -> wait(udp.buffer_waiter);
+
+			return;
+		}
+
+		res = udp.arm();
+	}
+
+	if(res) udp.stopped(res);
+}
+
+void xe_udp::buffer_ready(xe_buffer_waiter& waiter){
+	xe_udp& udp = xe_containerof(waiter, &xe_udp::buffer_waiter);
+	int err = udp.arm();
+
+	if(err) udp.stopped(err);
+}
+
+void xe_udp::deliver(xe_loop& loop, xe_hook& hook){
+	xe_udp& udp = xe_containerof(hook, &xe_udp::deliver_hook);
+
+	loop.cancel(hook);
+
+	if(udp.datagrams.size() && udp.callback)
+		udp.callback(udp, udp.datagrams.size(), udp.datagrams.data());
+	udp.datagrams.resize(0);
+
+	for(ushort bid : udp.buffers)
+		udp.ring -> recycle(bid);
+	udp.buffers.resize(0);
+}
+
+int xe_udp::arm(){
+	xe_return_error(loop_ -> run(recv_req, xe_op::recvmsg(fd_, &msg, 0).buffer_select(ring -> id()).recv_multishot()));
+
+	armed = true;
+
+	return 0;
+}
+
+void xe_udp::received(int res, uint flags){
+	ushort bid = xe_buffer_ring::buffer_id(flags);
+	byte* buf = (byte*)ring -> take(bid);
+	io_uring_recvmsg_out* out;
+	cmsghdr* cmsg;
+	xe_datagram datagram;
+	byte* payload;
+	uint len, segment;
+
+	out = res > 0 ? io_uring_recvmsg_validate(buf, res, &msg) : null;
+
+	if(!out || !buffers.push_back(bid)){
+		ring -> recycle(bid);
+
+		return;
+	}
+
+	payload = (byte*)io_uring_recvmsg_payload(out, &msg);
+	len = io_uring_recvmsg_payload_length(out, res, &msg);
+	segment = len;
+
+	datagram.addr = (const sockaddr*)io_uring_recvmsg_name(out);
+	datagram.addrlen = xe_min(out -> namelen, msg.msg_namelen);
+	datagram.truncated = out -> flags & MSG_TRUNC;
+
+	for(cmsg = io_uring_recvmsg_cmsg_firsthdr(out, &msg); cmsg; cmsg = io_uring_recvmsg_cmsg_nexthdr(out, &msg, cmsg)){
+		/* coalesced by gro, every datagram but the last is this long */
+		if(cmsg -> cmsg_level == SOL_UDP && cmsg -> cmsg_type == UDP_GRO)
+			segment = *(int*)CMSG_DATA(cmsg);
+	}
+
+	if(!segment) segment = len;
+
+	do{
+		datagram.data = payload;
+		datagram.len = xe_min(segment, len);
+
+		/* udp is lossy anyway, drop what doesn't fit */
+		if(!datagrams.push_back(datagram))
+			break;
+		payload += datagram.len;
+		len -= datagram.len;
+	}while(len);
+
+	if(!deliver_hook.active()) loop_ -> check(deliver_hook);
+}
+
+void xe_udp::stopped(int err){
+	active_ = false;
+
+	if(callback) callback(*this, err, null);
+}
+
+int xe_udp::init(int af){
+	int fd;
+
+	if(fd_ >= 0)
+		return XE_STATE;
+	fd = ::socket(af, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);
+
+	if(fd < 0)
+		return xe_errno();
+	fd_ = fd;
+
+	return 0;
+}
+
+int xe_udp::init_fd(int fd){
+	if(fd_ >= 0)
+		return XE_STATE;
+	fd_ = fd;
+
+	return 0;
+}
+
+int xe_udp::bind(const sockaddr* addr, socklen_t addrlen){
+	if(fd_ < 0)
+		return XE_STATE;
+	return ::bind(fd_, addr, addrlen) < 0 ? xe_errno() : 0;
+}
+
+int xe_udp::enable_gro(){
+	int yes = 1;
+
+	if(fd_ < 0 || active_)
+		return XE_STATE;
+	if(setsockopt(fd_, SOL_UDP, UDP_GRO, &yes, sizeof(yes)) < 0)
+		return xe_errno();
+	gro = true;
+
+	return 0;
+}
+
+int xe_udp::start(xe_buffer_ring& ring_){
+	if(fd_ < 0)
+		return XE_STATE;
+	if(active_ || armed)
+		return XE_EALREADY;
+	ring = &ring_;
+
+	/* the kernel lays each buffer out as header, address, control, payload */
+	msg.msg_namelen = sizeof(sockaddr_storage);
+	msg.msg_controllen = gro ? CMSG_SPACE(sizeof(int)) : 0;
+
+	xe_return_error(arm());
+
+	active_ = true;
+
+	return 0;
+}
+
+int xe_udp::stop(){
+	int res;
+
+	if(!active_)
+		return armed ? XE_EALREADY : 0;
+	active_ = false;
+
+	if(buffer_waiter.waiting()){
+		/* not armed, nothing left to stop */
+		buffer_waiter.cancel();
+
+		return 0;
+	}
+
+	res = loop_ -> cancel(xe_udp_cancel_req, recv_req, xe_op::cancel(0));
+
+	if(res != XE_EINPROGRESS)
+		active_ = true;
+	return res;
+}
+
+int xe_udp::send(xe_udp_send_req& req, const sockaddr* addr, socklen_t addrlen, xe_cptr buf, uint len, ushort segment_size){
+	cmsghdr* cmsg;
+
+	if(fd_ < 0)
+		return XE_STATE;
+	if(addrlen > sizeof(req.addr))
+		return XE_EINVAL;
+	if(segment_size && (size_t)len > (size_t)segment_size * XE_UDP_MAX_SEGMENTS)
+		return XE_EINVAL;
+	xe_zero(&req.msg);
+
+	req.iov.iov_base = (xe_ptr)buf;
+	req.iov.iov_len = len;
+	req.msg.msg_iov = &req.iov;
+	req.msg.msg_iovlen = 1;
+
+	if(addr){
+		xe_memcpy(&req.addr, addr, addrlen);
+
+		req.msg.msg_name = &req.addr;
+		req.msg.msg_namelen = addrlen;
+	}
+
+	if(segment_size && len > segment_size){
+		/* the kernel splits the buffer, or the nic does with udp segmentation offload */
+		req.msg.msg_control = req.control;
+		req.msg.msg_controllen = sizeof(req.control);
+
+		cmsg = CMSG_FIRSTHDR(&req.msg);
+		cmsg -> cmsg_level = SOL_UDP;
+		cmsg -> cmsg_type = UDP_SEGMENT;
+		cmsg -> cmsg_len = CMSG_LEN(sizeof(ushort));
+
+		xe_memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(ushort));
+	}
+
+	return loop_ -> run(req, xe_op::sendmsg(fd_, &req.msg, 0));
+}
+
+int xe_udp::close(){
+	if(active_ || armed)
+		return XE_STATE;
+	buffer_waiter.cancel();
+
+	if(deliver_hook.active())
+		loop_ -> cancel(deliver_hook);
+	datagrams.clear();
+
+	for(ushort bid : buffers)
+		ring -> recycle(bid);
+	buffers.clear();
+
+	if(fd_ >= 0) ::close(fd_);
+
+	fd_ = -1;
+	gro = false;
+
+	return 0;
+}
\ No newline at end of file
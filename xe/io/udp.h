@@ -0,0 +1,153 @@
+#pragma once
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "xstd/types.h"
+#include "xstd/vector.h"
+#include "xutil/util.h"
+#include "../loop.h"
+#include "../buffer.h"
+
+enum xe_udp_limits{
+	XE_UDP_MAX_SEGMENTS = 64 /* datagrams in one segmented send */
+};
+
+struct xe_datagram{
+	const sockaddr* addr;
+	socklen_t addrlen;
+	xe_ptr data;
+	uint len;
+	bool truncated; /* larger than the ring's buffers */
+};
+
+class xe_udp_send_req : public xe_req{
+private:
+	static void complete(xe_req&, int, uint);
+
+	msghdr msg;
+	iovec iov;
+	sockaddr_storage addr;
+	alignas(cmsghdr) byte control[CMSG_SPACE(sizeof(ushort))];
+
+	friend class xe_udp;
+public:
+	/* result: bytes sent */
+	typedef void (*xe_callback)(xe_udp_send_req& req, int result);
+
+	xe_callback callback;
+
+	xe_udp_send_req(xe_callback cb = null){
+		event = complete;
+		callback = cb;
+	}
+
+	xe_disable_copy_move(xe_udp_send_req)
+
+	~xe_udp_send_req() = default;
+};
+
+/*
+ * a udp endpoint, receiving with one multishot recvmsg into a buffer ring
+ * and sending many equal sized datagrams to a peer with a single segmented (UDP_SEGMENT) send
+ *
+ * datagrams received in one loop iteration are delivered together
+ */
+class xe_udp{
+private:
+	static void recv_complete(xe_req&, int, uint);
+	static void buffer_ready(xe_buffer_waiter&);
+	static void deliver(xe_loop&, xe_hook&);
+
+	int arm();
+	void received(int, uint);
+	void stopped(int);
+
+	xe_loop* loop_;
+	xe_buffer_ring* ring;
+
+	xe_req recv_req;
+	xe_buffer_waiter buffer_waiter;
+	xe_hook deliver_hook;
+	msghdr msg; /* layout of each received buffer, see io_uring_recvmsg_out */
+
+	xe_vector<xe_datagram> datagrams;
+	xe_vector<ushort> buffers; /* held until the batch is delivered */
+
+	int fd_;
+
+	bool gro: 1;
+	bool active_: 1; /* receiving */
+	bool armed: 1; /* the recvmsg is in flight */
+public:
+	/*
+	 * result > 0: datagrams holds result entries, valid until the callback returns
+	 * result < 0: receiving has stopped
+	 */
+	typedef void (*xe_callback)(xe_udp& udp, int result, xe_datagram* datagrams);
+
+	xe_callback callback;
+	void (*close_callback)(xe_udp& udp); /* the recvmsg ended after a stop */
+
+	xe_udp(){
+		recv_req.event = recv_complete;
+		buffer_waiter.callback = buffer_ready;
+		deliver_hook.callback = deliver;
+
+		ring = null;
+		xe_zero(&msg);
+
+		fd_ = -1;
+
+		gro = false;
+		active_ = false;
+		armed = false;
+
+		callback = null;
+		close_callback = null;
+	}
+
+	xe_udp(xe_loop& loop): xe_udp(){
+		loop_ = &loop;
+	}
+
+	xe_disable_copy_move(xe_udp)
+
+	void set_loop(xe_loop& loop){
+		loop_ = &loop;
+	}
+
+	xe_loop& loop() const{
+		return *loop_;
+	}
+
+	int fd() const{
+		return fd_;
+	}
+
+	bool active() const{
+		return active_;
+	}
+
+	int init(int af);
+	int init_fd(int fd);
+	int bind(const sockaddr* addr, socklen_t addrlen);
+
+	/* let the kernel coalesce datagrams from one flow, they are split again before delivery */
+	int enable_gro();
+
+	/* the ring's buffers must fit a datagram, or a coalesced run with gro, plus the peer address */
+	int start(xe_buffer_ring& ring);
+
+	/* XE_EINPROGRESS if the recvmsg is still armed, close_callback runs once it ends */
+	int stop();
+
+	/*
+	 * send len bytes to addr as datagrams of segment_size bytes (the last may be shorter),
+	 * at most XE_UDP_MAX_SEGMENTS of them. segment_size 0 sends a single datagram
+	 */
+	int send(xe_udp_send_req& req, const sockaddr* addr, socklen_t addrlen, xe_cptr buf, uint len, ushort segment_size = 0);
+
+	/* XE_STATE until stopped and the receive has ended */
+	int close();
+
+	~xe_udp() = default;
+};
\ No newline at end of file
@@ -1,3 +1,5 @@
+#include <unistd.h>
+#include <sys/eventfd.h>
 #include <linux/version.h>
 #include "loop.h"
 #include "clock.h"
@@ -5,13 +7,42 @@
 #include "xutil/log.h"
 #include "xutil/assert.h"
 
+#ifdef XE_ENABLE_STATS
+	#define xe_loop_stat(...) __VA_ARGS__
+#else
+	#define xe_loop_stat(...)
+#endif
+
+#if defined IO_URING_VERSION_MAJOR && (IO_URING_VERSION_MAJOR > 2 || IO_URING_VERSION_MINOR >= 9)
+	#define XE_RESIZE_RINGS 1
+#endif
+
+#if defined IO_URING_VERSION_MAJOR && (IO_URING_VERSION_MAJOR > 2 || IO_URING_VERSION_MINOR >= 6)
+	#define XE_NAPI 1
+#endif
+
 enum{
 	ENTRY_COUNT = 256, /* default sqe and cqe count */
+	MAX_ENTRY_COUNT = 32768, /* kernel limit on sqes */
+	MAX_CQ_ENTRY_COUNT = 2 * MAX_ENTRY_COUNT,
+	ADAPT_WINDOW = 4096, /* loop iterations between shrink checks */
+	TIMER_RESOLUTION = 1'000'000, /* default timer wheel tick, 1 ms */
 
 	/* useful in the case that not all sqes were submitted and no events return in time */
 	MAX_WAIT = 4'000'000'000 /* 4 seconds */
 };
 
+/* completion target for linked timeouts, nobody waits for them */
+static xe_req link_timeout_req;
+
+/* completion target for direct descriptor closes */
+static xe_req close_direct_req;
+
+static inline void xe_set_timespec(__kernel_timespec& ts, ulong ns){
+	ts.tv_sec = ns / XE_NANOS_PER_SEC;
+	ts.tv_nsec = ns % XE_NANOS_PER_SEC;
+}
+
 void xe_promise::complete(xe_req& req, int result, uint flags){
 	xe_promise& promise = (xe_promise&)req;
 
@@ -51,6 +82,14 @@ static inline int xe_ring_enter(io_uring& ring, uint submit, uint wait, uint fla
 	return io_uring_enter2(ring.ring_fd, submit, wait, flags, (sigset_t*)&args, sizeof(args));
 }
 
+static inline void xe_cpu_relax(){
+#if defined __x86_64__ || defined __i386__
+	__builtin_ia32_pause();
+#elif defined __aarch64__
+	asm volatile("yield");
+#endif
+}
+
 static inline bool xe_cqe_test_flags(io_uring& ring, uint flags){
 	return IO_URING_READ_ONCE(*ring.sq.kflags) & flags ? true : false;
 }
@@ -80,6 +119,8 @@ inline int xe_loop::submit(bool want_events){
 
 	ulong timeout;
 
+	xe_loop_stat(ulong enter_start;)
+
 	submit = queued_;
 	flags = 0;
 	wait = 0;
@@ -92,7 +133,7 @@ inline int xe_loop::submit(bool want_events){
 		xe_rbtree<xe_timer>::iterator it;
 		ulong now;
 
-		if(!(submit | handles_ | active_timers)) [[unlikely]] {
+		if(!(submit | (handles_ - passive_) | active_timers)) [[unlikely]] {
 			/* done */
 			return XE_ENOENT;
 		}
@@ -114,19 +155,39 @@ inline int xe_loop::submit(bool want_events){
 			break;
 		}
 
-		now = xe_time_ns();
-		it = timers.begin();
+		now = update_time();
+		time_stale = false;
 		timeout = MAX_WAIT;
 		wait = 1;
 
-		if(it != timers.end()){
-			/* we may have to exit early to run the timer */
-			if(now < it -> expire)
-				timeout = xe_min<ulong>(it -> expire - now, MAX_WAIT);
-			else{
-				/* if timer already expired, just submit and/or flush cqe, don't wait */
-				wait = 0;
+		if(!timer_wheel) [[likely]] {
+			it = timers.begin();
+
+			if(it != timers.end()){
+				/* we may have to exit early to run the timer */
+				if(now < it -> expire)
+					timeout = xe_min<ulong>(it -> expire - now, MAX_WAIT);
+				else{
+					/* if timer already expired, just submit and/or flush cqe, don't wait */
+					wait = 0;
+				}
 			}
+		}else{
+			timeout = xe_min<ulong>(wheel.next(now), MAX_WAIT);
+
+			if(!timeout) wait = 0;
+		}
+
+		if(!idle_hooks.empty()) [[unlikely]]
+			wait = 0;
+
+		if(spin_max && wait) [[unlikely]] {
+			/* submit without blocking and spin on the next pass */
+			if(submit)
+				wait = 0;
+			else if(spin(now, timeout, wait))
+				return 0;
+			break;
 		}
 
 		if(submit || wait) [[likely]]
@@ -165,8 +226,22 @@ inline int xe_loop::submit(bool want_events){
 		goto sqpoll_done;
 	}while(false);
 
+	xe_loop_stat(
+		enter_start = xe_time_ns();
+		xe_loop_stats::add(stats_.running_ns, enter_start - stats_mark);
+	)
+
 	res = xe_ring_enter(ring, submit, wait, flags, timeout);
 
+	/* blocked, the time read above is out of date */
+	if(wait) time_stale = true;
+
+	xe_loop_stat(
+		stats_mark = xe_time_ns();
+		xe_loop_stats::add(wait ? stats_.blocked_ns : stats_.running_ns, stats_mark - enter_start);
+		stats_.enter(res > 0 && submit ? res : 0);
+	)
+
 	if(res >= 0) [[likely]] {
 	sqpoll_done:
 		sq_ring_full = false;
@@ -186,10 +261,15 @@ inline int xe_loop::submit(bool want_events){
 		return 0;
 	}
 
-	if(res == XE_ETIME || res == XE_EBUSY || res == XE_EINTR) [[likely]]
+	if(res == XE_ETIME || res == XE_EBUSY || res == XE_EINTR) [[likely]] {
+		xe_loop_stat(if(res == XE_EBUSY) xe_loop_stats::add(stats_.ebusy, 1);)
+
 		return 0;
+	}
+
 	if(res == XE_EAGAIN){
 		xe_log_debug(this, ">> ring queue full");
+		xe_loop_stat(xe_loop_stats::add(stats_.eagain, 1);)
 
 		sq_ring_full = true;
 
@@ -201,9 +281,51 @@ inline int xe_loop::submit(bool want_events){
 	return res == XE_EBADR ? XE_ENOMEM : XE_FATAL;
 }
 
+bool xe_loop::spin(ulong now, ulong& timeout, uint& wait){
+	ulong budget, deadline, time;
+
+	/*
+	 * spin for about two inter-arrival times if completions arrive within the budget,
+	 * otherwise spin briefly so a return to a high rate is noticed
+	 */
+	if(arrival_avg <= spin_max)
+		budget = xe_min(arrival_avg * 2, spin_max);
+	else
+		budget = spin_max / 16;
+	budget = xe_min(budget, timeout);
+	deadline = now + budget;
+	time = now;
+
+	do{
+		if(xe_cqe_available(ring)){
+			/* the last read while spinning stands in for the iteration's time */
+			if(time > now_) now_ = time;
+
+			return true;
+		}
+		if(xe_cqe_needs_enter(ring)){
+			/* task work or overflowed cqes, flush without waiting */
+			wait = 0;
+
+			return false;
+		}
+
+		xe_cpu_relax();
+		time = clock();
+	}while(time < deadline);
+
+	if(timeout > time - now)
+		timeout -= time - now;
+	else
+		wait = 0;
+	return false;
+}
+
 void xe_loop::run_timer(xe_timer& timer, ulong now){
 	ulong align, delay;
 
+	xe_loop_stat(stats_.timer(now > timer.expire ? now - timer.expire : 0);)
+
 	erase_timer(timer);
 
 	timer.in_callback = true;
@@ -250,7 +372,10 @@ void xe_loop::queue_timer(xe_timer& timer){
 
 	if(!timer.passive_)
 		active_timers++;
-	timers.insert(timer);
+	if(!timer_wheel) [[likely]]
+		timers.insert(timer);
+	else
+		wheel.insert(timer);
 }
 
 void xe_loop::erase_timer(xe_timer& timer){
@@ -258,7 +383,10 @@ void xe_loop::erase_timer(xe_timer& timer){
 
 	if(!timer.passive_)
 		active_timers--;
-	timers.erase(timer);
+	if(!timer_wheel) [[likely]]
+		timers.erase(timer);
+	else
+		wheel.erase(timer);
 }
 
 inline int xe_loop::queue_io(xe_req_info& info){
@@ -284,6 +412,34 @@ enqueue:
 	return 0;
 }
 
+int xe_loop::queue_chain(xe_req_info& head){
+	uint length = head.chain;
+	int res;
+
+	if(remain() < length){
+		res = submit(false);
+
+		if(res)
+			return res;
+		if(remain() < length)
+			return XE_EAGAIN;
+	}
+
+	/* the rest of the chain follows the head in the deferred queue */
+	for(uint i = 0; i < length && reqs; i++){
+		xe_req_info& info = reqs.front();
+
+		info.chain = 0;
+		info.chained = false;
+
+		queue_io(info);
+		reqs.erase(info);
+		xe_loop_stat(deferred_--;)
+	}
+
+	return 0;
+}
+
 int xe_loop::queue_pending(){
 	/* submit deferred requests */
 	int err;
@@ -296,14 +452,22 @@ int xe_loop::queue_pending(){
 	}
 
 	while(reqs){
-		err = queue_io(reqs.front());
-
-		if(!err)
+		if(reqs.front().chain > 1) [[unlikely]]
+			err = queue_chain(reqs.front());
+		else if(!(err = queue_io(reqs.front()))){
 			reqs.erase(reqs.front());
-		else if(err != XE_EAGAIN)
+			xe_loop_stat(deferred_--;)
+		}
+		if(!err)
+			continue;
+		if(err != XE_EAGAIN)
 			return err;
-		else
-			break;
+		break;
+	}
+
+	if(post_deferred && !post_info.linked()) [[unlikely]] {
+		post_deferred = false;
+		passive_++;
 	}
 
 	return 0;
@@ -341,7 +505,10 @@ int xe_loop::get_sqe(xe_req& req, io_uring_sqe*& sqe, xe_req_info* info){
 
 		if(!info)
 			return XE_ENOMEM;
+		info -> chain = 0;
+		info -> chained = false;
 		reqs.append(*info);
+		xe_loop_stat(xe_loop_stats::peak(stats_.deferred_peak, ++deferred_);)
 		sqe = &info -> op.sqe;
 
 		return 0;
@@ -354,6 +521,254 @@ int xe_loop::get_sqe(xe_req& req, io_uring_sqe*& sqe, xe_req_info* info){
 	return 0;
 }
 
+void xe_loop::post_read_complete(xe_req& req, int res, uint flags){
+	xe_loop& loop = xe_containerof(req, &xe_loop::post_read);
+
+	loop.passive_--;
+
+	if(res < 0){
+		xe_log_error(&loop, ">> post wakeup failed: %s", xe_strerror(res));
+
+		return;
+	}
+
+	loop.run_posts();
+	loop.arm_post();
+}
+
+void xe_loop::post_wake_complete(xe_req& req, int res, uint flags){
+	xe_loop& loop = xe_containerof(req, &xe_loop::post_wake);
+
+	/* not one of our requests */
+	loop.handles_++;
+	loop.run_posts();
+}
+
+/* a msg_ring send, completes on the sender */
+struct xe_post_msg{
+	xe_req req;
+	xe_loop* target;
+};
+
+void xe_loop::post_msg_complete(xe_req& req, int res, uint flags){
+	xe_post_msg& msg = xe_containerof(req, &xe_post_msg::req);
+
+	/* runs on the sender, the target didn't get the message */
+	if(res < 0) msg.target -> wake();
+	xe_delete(&msg);
+}
+
+int xe_loop::arm_post(){
+	int err = run(post_read, xe_op::read(post_fd, &post_value, sizeof(post_value), 0), &post_info);
+
+	if(err){
+		xe_log_error(this, ">> failed to arm post wakeup: %s", xe_strerror(err));
+
+		return err;
+	}
+
+	/* only a submitted read counts against handles_, queue_pending counts a deferred one */
+	if(post_info.linked())
+		post_deferred = true;
+	else
+		passive_++;
+	return 0;
+}
+
+bool xe_loop::push(xe_post& task){
+	xe_post* head = posts.load(std::memory_order_relaxed);
+
+	do{
+		task.next = head;
+	}while(!posts.compare_exchange_weak(head, &task, std::memory_order_release, std::memory_order_relaxed));
+
+	/* only the first post since the last drain needs to wake the loop */
+	return !head;
+}
+
+int xe_loop::wake(){
+	if(eventfd_write(post_fd, 1) < 0)
+		return xe_errno();
+	return 0;
+}
+
+void xe_loop::run_posts(){
+	xe_post* task;
+	xe_post* prev;
+	xe_post* next;
+
+	task = posts.exchange(null, std::memory_order_acquire);
+	prev = null;
+
+	/* restore posting order */
+	while(task){
+		next = task -> next;
+		task -> next = prev;
+		prev = task;
+		task = next;
+	}
+
+	while(prev){
+		next = prev -> next;
+		prev -> callback(*this, *prev);
+		prev = next;
+	}
+}
+
+int xe_loop::run_chain(xe_chain& chain){
+	io_uring_sqe* sqe;
+	byte link;
+	int res;
+
+	xe_return_error(error);
+
+	if(chain.overflow || chain.length > capacity())
+		return XE_EINVAL;
+	if(!chain.length)
+		return 0;
+	link = chain.hard ? IOSQE_IO_HARDLINK : IOSQE_IO_LINK;
+
+	do{
+		if(remain() >= chain.length) [[likely]]
+			break;
+		/*
+		 * a chain split across two submissions loses its links,
+		 * make room for all of it or defer all of it
+		 */
+		if(sq_ring_full) [[unlikely]]
+			res = XE_EAGAIN;
+		else
+			res = submit(false);
+		if(!res && remain() >= chain.length)
+			break;
+		if(res && res != XE_EAGAIN) [[unlikely]] {
+			error = res;
+
+			return res;
+		}
+
+		for(uint i = 0; i < chain.length; i++){
+			if(!chain.entries[i].info)
+				return XE_ENOMEM;
+		}
+
+		for(uint i = 0; i < chain.length; i++){
+			xe_req_info& info = *chain.entries[i].info;
+
+			info.op = chain.entries[i].op;
+			info.op.sqe.user_data = (ulong)chain.entries[i].req;
+			info.chain = i ? 0 : chain.length;
+			info.chained = true;
+
+			if(i + 1 < chain.length)
+				info.op.sqe.flags |= link;
+			reqs.append(info);
+			xe_loop_stat(xe_loop_stats::peak(stats_.deferred_peak, ++deferred_);)
+		}
+
+		return 0;
+	}while(false);
+
+	for(uint i = 0; i < chain.length; i++){
+		queued_++;
+		sqe = &ring.sq.sqes[ring.sq.sqe_tail++ & ring.sq.ring_mask];
+
+		/* copy io parameters */
+		*sqe = chain.entries[i].op.sqe;
+		sqe -> user_data = (ulong)chain.entries[i].req;
+
+		if(i + 1 < chain.length)
+			sqe -> flags |= link;
+	}
+
+	return 0;
+}
+
+int xe_chain::submit(){
+	return loop.run_chain(*this);
+}
+
+bool xe_loop::adapt(){
+	uint entries, cq_entries;
+	bool overflow;
+
+	entries = ring.sq.ring_entries;
+	cq_entries = ring.cq.ring_entries;
+	overflow = xe_cqe_needs_flush(ring);
+	peak_sq = xe_max(peak_sq, queued_);
+
+	if(sq_ring_full || reqs || overflow) [[unlikely]] {
+		/* requests are waiting for sqes or cqes are being dropped into the overflow list */
+		if(overflow && (entries << cq_shift) < MAX_CQ_ENTRY_COUNT)
+			cq_shift++;
+		if(sq_ring_full || reqs)
+			entries = xe_min(entries << 1, max_entries);
+		cq_entries = xe_min<uint>(entries << cq_shift, MAX_CQ_ENTRY_COUNT);
+
+		if(entries == ring.sq.ring_entries && cq_entries == ring.cq.ring_entries)
+			return false;
+	}else{
+		if(++window < ADAPT_WINDOW)
+			return false;
+		window = 0;
+
+		/* shrink if the last window used less than a quarter of the rings */
+		if(entries <= min_entries || peak_sq > entries / 4 || peak_cq > cq_entries / 4 || handles_ > cq_entries / 2){
+			peak_sq = 0;
+			peak_cq = 0;
+
+			return false;
+		}
+
+		entries >>= 1;
+		cq_entries >>= 1;
+	}
+
+	peak_sq = 0;
+	peak_cq = 0;
+
+	return resize(entries, cq_entries) == 0;
+}
+
+int xe_loop::resize(uint entries, uint cq_entries){
+#ifdef XE_RESIZE_RINGS
+	io_uring_params params;
+	int res;
+
+	/* the kernel only copies sqes that were submitted to it */
+	if(queued_ && ((res = submit(false)) || queued_))
+		return res ?: XE_EAGAIN;
+	xe_zero(&params);
+
+	params.sq_entries = entries;
+	params.cq_entries = cq_entries;
+	params.flags = IORING_SETUP_CQSIZE;
+
+	res = io_uring_resize_rings(&ring, &params);
+
+	if(res < 0){
+		if(res == XE_EINVAL || res == XE_EOPNOTSUPP){
+			/* kernel doesn't support resizing */
+			adaptive = false;
+		}
+
+		xe_log_debug(this, ">> ring resize failed: %s", xe_strerror(res));
+
+		return res;
+	}
+
+	xe_log_debug(this, ">> ring resized to %u sqes %u cqes", ring.sq.ring_entries, ring.cq.ring_entries);
+
+	sq_ring_full = false;
+
+	return 0;
+#else
+	adaptive = false;
+
+	return XE_ENOSYS;
+#endif
+}
+
 int xe_loop::init(uint entries){
 	xe_loop_options options;
 
@@ -365,6 +780,7 @@ int xe_loop::init(uint entries){
 int xe_loop::init_options(xe_loop_options& options){
 	io_uring_params params;
 	byte* io_buf_;
+	int post_fd_;
 	int err;
 
 	if(!options.entries)
@@ -409,6 +825,7 @@ int xe_loop::init_options(xe_loop_options& options){
 	}
 
 	io_buf_ = null;
+	post_fd_ = -1;
 
 	if(options.flag_iobuf){
 		io_buf_ = xe_alloc_aligned<byte>(0, XE_LOOP_IOBUF_SIZE_LARGE);
@@ -418,18 +835,127 @@ int xe_loop::init_options(xe_loop_options& options){
 		xe_zero(io_buf_, XE_LOOP_IOBUF_SIZE_LARGE);
 	}
 
+	if(options.flag_post){
+		post_fd_ = eventfd(0, EFD_CLOEXEC);
+
+		if(post_fd_ < 0){
+			err = xe_errno();
+			xe_dealloc(io_buf_);
+
+			return err;
+		}
+	}
+
 	err = io_uring_queue_init_params(options.entries, &ring, &params);
 
-	if(err)
+	if(err){
 		xe_dealloc(io_buf_);
-	else
-		io_buf = io_buf_;
-	return err;
+
+		if(post_fd_ >= 0) ::close(post_fd_);
+
+		return err;
+	}
+
+	io_buf = io_buf_;
+
+	if(options.direct_files){
+		err = register_files_sparse(options.direct_files);
+
+		if(err){
+			io_uring_queue_exit(&ring);
+			xe_dealloc(io_buf_);
+
+			if(post_fd_ >= 0) ::close(post_fd_);
+
+			io_buf = null;
+
+			return err;
+		}
+
+		direct_files_ = options.direct_files;
+	}
+
+	if(options.fixed_buffers){
+		err = fixed.init(*this, options.fixed_buffers);
+
+		if(err){
+			io_uring_queue_exit(&ring);
+			xe_dealloc(io_buf_);
+
+			if(post_fd_ >= 0) ::close(post_fd_);
+
+			io_buf = null;
+			direct_files_ = 0;
+
+			return err;
+		}
+	}
+
+	if(post_fd_ >= 0){
+		post_fd = post_fd_;
+		post_read.event = post_read_complete;
+		post_wake.event = post_wake_complete;
+
+		arm_post();
+	}
+
+	if(options.flag_adaptive){
+		adaptive = true;
+		min_entries = ring.sq.ring_entries;
+		max_entries = xe_min<uint>(options.max_entries ? options.max_entries : MAX_ENTRY_COUNT, MAX_ENTRY_COUNT);
+		cq_shift = 0;
+
+		while((ring.sq.ring_entries << cq_shift) < ring.cq.ring_entries)
+			cq_shift++;
+	}
+
+	if(options.napi_busy_poll_us){
+		err = register_napi(options.napi_busy_poll_us, options.flag_napi_prefer_busy_poll);
+
+		/* not fatal, the loop works the same without it */
+		if(err) xe_log_debug(this, ">> napi busy poll unavailable: %s", xe_strerror(err));
+	}
+
+	/* falls back to the system clock without an invariant tsc */
+	if(options.flag_tsc_clock) tsc = xe_tsc_init();
+
+	now_ = clock();
+	calibrated = now_;
+
+	if(options.spin_ns){
+		spin_max = options.spin_ns;
+		arrival_avg = spin_max;
+		last_arrival = now_;
+	}
+
+	xe_loop_stat(stats_mark = xe_time_ns();)
+
+	/* tasks started on this thread take their frames from this loop */
+	xe_frame_pool::set_current(&frames);
+
+	if(options.flag_timer_wheel){
+		if(!options.timer_resolution) options.timer_resolution = TIMER_RESOLUTION;
+
+		timer_wheel = true;
+		wheel.init(options.timer_resolution, now_);
+	}
+
+	return 0;
 }
 
 void xe_loop::close(){
 	io_uring_queue_exit(&ring);
 	xe_dealloc(io_buf);
+
+	if(post_fd >= 0) ::close(post_fd);
+
+	post_fd = -1;
+	direct_files_ = 0;
+	fixed.close();
+
+	if(xe_frame_pool::current() == &frames)
+		xe_frame_pool::set_current(null);
+	frames.clear();
 }
 
 int xe_loop::run(){
@@ -439,26 +965,74 @@ int xe_loop::run(){
 	uint cqe_head;
 	uint cqe_tail;
 	uint cqe_mask;
+	uint* khead;
+	io_uring_cqe* cqring;
 
 	cqe_head = *ring.cq.khead;
 	cqe_mask = ring.cq.ring_mask;
 
 	while(true){
+		if(adaptive) [[unlikely]] {
+			if(adapt())
+				cqe_mask = ring.cq.ring_mask;
+		}
+
+		if(!idle_hooks.empty()) [[unlikely]] {
+			run_hooks(idle_hooks);
+
+			if(error) [[unlikely]]
+				goto exit_error;
+		}
+
+		/* last chance to queue work before waiting */
+		if(!prepare_hooks.empty()) [[unlikely]] {
+			run_hooks(prepare_hooks);
+
+			if(error) [[unlikely]]
+				goto exit_error;
+		}
+
 		xe_return_error(queue_pending());
 
+		/* submit reads the time for its wait, reuse it unless it blocked */
+		time_stale = true;
 		res = submit(true);
 
 		if(res) [[unlikely]]
 			goto exit;
-		now = xe_time_ns();
+		now = time_stale ? update_time() : now_;
+
+		if(tsc && now - calibrated >= XE_NANOS_PER_SEC) [[unlikely]] {
+			xe_tsc_calibrate();
+			calibrated = now;
+		}
 
 		/* process outstanding timers */
-		for(auto it = timers.begin(); it != timers.end(); it = timers.begin()){
-			xe_timer& timer = *it;
+		if(!timer_wheel) [[likely]] {
+			for(auto it = timers.begin(); it != timers.end(); it = timers.begin()){
+				xe_timer& timer = *it;
+
+				if(now < timer.expire)
+					break;
+				run_timer(timer, now);
+
+				if(error) [[unlikely]]
+					goto exit_error;
+			}
+		}else{
+			wheel.advance(now);
 
-			if(now < timer.expire)
-				break;
-			run_timer(timer, now);
+			while(xe_timer* timer = wheel.expired()){
+				run_timer(*timer, now);
+
+				if(error) [[unlikely]]
+					goto exit_error;
+			}
+		}
+
+		/* tasks from other threads */
+		if(posts.load(std::memory_order_relaxed)) [[unlikely]] {
+			run_posts();
 
 			if(error) [[unlikely]]
 				goto exit_error;
@@ -467,13 +1041,20 @@ int xe_loop::run(){
 		cqe_tail = *ring.cq.ktail;
 
 		if(cqe_tail == cqe_head)
-			continue;
+			goto check;
+		if(spin_max) [[unlikely]] {
+			arrival_avg = (arrival_avg * 7 + xe_min(now - last_arrival, spin_max * 16)) / 8;
+			last_arrival = now;
+		}
+		if(adaptive) [[unlikely]]
+			peak_cq = xe_max(peak_cq, cqe_tail - cqe_head);
 		/* pending reqs take priority */
 		xe_return_error(queue_pending());
 		xe_log_trace(this, ">> ring %u", cqe_tail - cqe_head);
+		xe_loop_stat(stats_.batch(cqe_tail - cqe_head);)
 
-		uint* khead = ring.cq.khead;
-		io_uring_cqe* cqring = ring.cq.cqes;
+		khead = ring.cq.khead;
+		cqring = ring.cq.cqes;
 
 		/* process events */
 		do{
@@ -500,6 +1081,13 @@ int xe_loop::run(){
 			if(error) [[unlikely]]
 				goto exit_error;
 		}while(cqe_tail != cqe_head);
+	check:
+		if(!check_hooks.empty()) [[unlikely]] {
+			run_hooks(check_hooks);
+
+			if(error) [[unlikely]]
+				goto exit_error;
+		}
 	}
 exit:
 	return res == XE_ENOENT ? 0 : res;
@@ -507,6 +1095,49 @@ exit_error:
 	return error;
 }
 
+int xe_loop::with_timeout(xe_req& req, xe_op op, xe_deadline& deadline, ulong ns){
+	xe_set_timespec(deadline.ts, ns);
+
+	return chain()
+		.add(op, req, &deadline.info[0])
+		.add(xe_op::link_timeout(&deadline.ts, 0), link_timeout_req, &deadline.info[1])
+		.submit();
+}
+
+xe_timeout_promise xe_loop::with_timeout(xe_op op, ulong ns){
+	xe_timeout_promise promise;
+	int res;
+
+	xe_set_timespec(promise.ts, ns);
+
+	res = chain()
+		.add(op, promise)
+		.add(xe_op::link_timeout(&promise.ts, 0), link_timeout_req)
+		.submit();
+	if(res){
+		promise.result_ = res;
+		promise.ready_ = true;
+	}
+
+	return promise;
+}
+
+xe_timeout_promise xe_loop::timeout(ulong ns, uint flags){
+	xe_timeout_promise promise;
+	int res;
+
+	xe_set_timespec(promise.ts, ns);
+
+	res = run(promise, xe_op::timeout(&promise.ts, 0, flags));
+
+	if(res){
+		promise.result_ = res;
+		promise.ready_ = true;
+	}
+
+	return promise;
+}
+
 uint xe_loop::sqe_count() const{
 	return ring.sq.ring_entries;
 }
@@ -543,6 +1174,35 @@ int xe_loop::flush(){
 	return error;
 }
 
+int xe_loop::post(xe_post& task){
+	if(post_fd < 0)
+		return XE_STATE;
+	if(!push(task))
+		return 0;
+	return wake();
+}
+
+int xe_loop::post(xe_post& task, xe_loop& from){
+	if(post_fd < 0)
+		return XE_STATE;
+	if(!push(task))
+		return 0;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 18, 0)
+	xe_post_msg* msg;
+
+	/* rides along with the sender's next submit instead of a write syscall */
+	if(&from != this && (msg = xe_new<xe_post_msg>())){
+		msg -> req.event = post_msg_complete;
+		msg -> target = this;
+
+		if(!from.run(msg -> req, xe_op::msg_ring(ring.ring_fd, 0, (ulong)&post_wake, 0)))
+			return 0;
+		xe_delete(msg);
+	}
+#endif
+	return wake();
+}
+
 int xe_loop::timer_ms(xe_timer& timer, ulong millis, ulong repeat, uint flags){
 	return timer_ns(timer, millis * XE_NANOS_PER_MS, repeat * XE_NANOS_PER_MS, flags);
 }
@@ -551,7 +1211,7 @@ int xe_loop::timer_ns(xe_timer& timer, ulong nanos, ulong repeat, uint flags){
 	if(timer.active_)
 		return XE_EALREADY;
 	if(!(flags & XE_TIMER_ABS))
-		nanos += xe_time_ns();
+		nanos += now_;
 	timer.delay = repeat;
 	timer.repeat_ = flags & XE_TIMER_REPEAT ? true : false;
 	timer.align_ = flags & XE_TIMER_ALIGN ? true : false;
@@ -563,6 +1223,55 @@ int xe_loop::timer_ns(xe_timer& timer, ulong nanos, ulong repeat, uint flags){
 	return 0;
 }
 
+int xe_loop::add_hook(xe_linked_list<xe_hook>& hooks, xe_hook& hook){
+	if(hook.active_)
+		return XE_EALREADY;
+	if(!hook.callback)
+		return XE_EINVAL;
+	hook.active_ = true;
+	hooks.append(hook);
+
+	return 0;
+}
+
+void xe_loop::run_hooks(xe_linked_list<xe_hook>& hooks){
+	hook_next = hooks.begin();
+
+	while(hook_next != hooks.end()){
+		xe_hook& hook = *hook_next++;
+
+		hook.callback(*this, hook);
+
+		if(error) [[unlikely]]
+			break;
+	}
+
+	hook_next = {};
+}
+
+int xe_loop::prepare(xe_hook& hook){
+	return add_hook(prepare_hooks, hook);
+}
+
+int xe_loop::check(xe_hook& hook){
+	return add_hook(check_hooks, hook);
+}
+
+int xe_loop::idle(xe_hook& hook){
+	return add_hook(idle_hooks, hook);
+}
+
+int xe_loop::cancel(xe_hook& hook){
+	if(!hook.active_)
+		return XE_ENOENT;
+	if(hook_next == xe_linked_list<xe_hook>::iterator(&hook))
+		hook_next++;
+	hook.active_ = false;
+	hook.erase();
+
+	return 0;
+}
+
 int xe_loop::cancel(xe_timer& timer){
 	/* a timer in callback is not active */
 	if(timer.in_callback){
@@ -632,6 +1341,58 @@ int xe_loop::unregister_files(){
 	return io_uring_unregister_files(&ring);
 }
 
+uint xe_loop::direct_files() const{
+	return direct_files_;
+}
+
+int xe_loop::close_direct(uint index){
+	int fd = -1;
+
+	if(!run(close_direct_req, xe_op::close_direct(index + 1)))
+		return 0;
+	/* no sqe, clear the slot synchronously */
+	return xe_min(register_files_update(index, &fd, 1), 0);
+}
+
+int xe_loop::register_napi(uint busy_poll_us, bool prefer_busy_poll){
+#ifdef XE_NAPI
+	io_uring_napi napi;
+
+	xe_zero(&napi);
+
+	napi.busy_poll_to = busy_poll_us;
+	napi.prefer_busy_poll = prefer_busy_poll;
+
+	return io_uring_register_napi(&ring, &napi);
+#else
+	return XE_ENOSYS;
+#endif
+}
+
+int xe_loop::unregister_napi(){
+#ifdef XE_NAPI
+	return io_uring_unregister_napi(&ring, null);
+#else
+	return XE_ENOSYS;
+#endif
+}
+
+int xe_loop::register_buf_ring(io_uring_buf_ring* br, uint entries, ushort bgid){
+	io_uring_buf_reg reg;
+
+	xe_zero(&reg);
+
+	reg.ring_addr = (ulong)br;
+	reg.ring_entries = entries;
+	reg.bgid = bgid;
+
+	return io_uring_register_buf_ring(&ring, &reg, 0);
+}
+
+int xe_loop::unregister_buf_ring(ushort bgid){
+	return io_uring_unregister_buf_ring(&ring, bgid);
+}
+
 xe_cstr xe_loop::class_name(){
 	return "xe_loop";
 }
\ No newline at end of file
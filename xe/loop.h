@@ -14,12 +14,19 @@ typedef typename std::coroutine_handle<> xe_coroutine_handle;
 #endif
 
 #include <chrono>
+#include <atomic>
 #include <liburing.h>
+#include "xconfig/config.h"
 #include "xstd/types.h"
 #include "xstd/rbtree.h"
 #include "xstd/linked_list.h"
 #include "xutil/util.h"
 #include "error.h"
+#include "clock.h"
+#include "wheel.h"
+#include "frame.h"
+#include "fixed.h"
+#include "stats.h"
 #include "op.h"
 
 enum xe_iobuf_size{
@@ -30,10 +37,15 @@ enum xe_iobuf_size{
 class xe_req_info : protected xe_linked_node{
 private:
 	xe_op op;
+	uint chain; /* length of the deferred chain this request starts */
+	bool chained: 1; /* deferred as part of a chain */
 
 	friend class xe_loop;
 public:
-	xe_req_info() = default;
+	xe_req_info(){
+		chain = 0;
+		chained = false;
+	}
 
 	xe_disable_copy_move(xe_req_info)
 
@@ -54,15 +66,16 @@ public:
 enum xe_timer_flags{
 	XE_TIMER_NONE = 0x0,
 	XE_TIMER_REPEAT = 0x1,
-	XE_TIMER_ABS = 0x2,
+	XE_TIMER_ABS = 0x2, /* time is in the clock of xe_loop::now() */
 	XE_TIMER_ALIGN = 0x4, /* set next timeout to expire time + repeat instead of now + repeat */
 	XE_TIMER_PASSIVE = 0x8 /* timer does not prevent loop from exiting */
 };
 
-class xe_timer : public xe_rb_node{
+class xe_timer : public xe_rb_node, protected xe_linked_node{
 private:
 	ulong expire;
 	ulong delay;
+	ushort slot; /* position in the timer wheel */
 
 	bool active_: 1;
 	bool repeat_: 1;
@@ -71,12 +84,14 @@ private:
 	bool in_callback: 1;
 
 	friend class xe_loop;
+	friend class xe_timer_wheel;
 public:
 	int (*callback)(xe_loop& loop, xe_timer& timer);
 
 	xe_timer(){
 		expire = 0;
 		delay = 0;
+		slot = 0;
 
 		active_ = false;
 		repeat_ = false;
@@ -120,11 +135,117 @@ public:
 	~xe_timer() = default;
 };
 
+enum xe_chain_limits{
+	XE_CHAIN_MAX = 16
+};
+
+/*
+ * linked requests that are placed in the sq ring together,
+ * or deferred together when there isn't room for all of them
+ */
+class xe_chain{
+private:
+	struct xe_chain_entry{
+		xe_op op;
+		xe_req* req;
+		xe_req_info* info;
+	};
+
+	xe_loop& loop;
+	xe_chain_entry entries[XE_CHAIN_MAX];
+
+	uint length;
+	bool hard: 1;
+	bool overflow: 1;
+
+	friend class xe_loop;
+public:
+	xe_chain(xe_loop& loop, bool hard): loop(loop){
+		length = 0;
+
+		this -> hard = hard;
+		overflow = false;
+	}
+
+	xe_disable_copy_move(xe_chain)
+
+	/* info is required for the chain to be deferred when the sq ring is full */
+	xe_chain& add(xe_op op, xe_req& req, xe_req_info* info = null){
+		if(length >= XE_CHAIN_MAX) [[unlikely]] {
+			overflow = true;
+
+			return *this;
+		}
+
+		entries[length].op = op;
+		entries[length].req = &req;
+		entries[length].info = info;
+		length++;
+
+		return *this;
+	}
+
+	int submit();
+
+	~xe_chain() = default;
+};
+
+/* a task handed to a loop from another thread */
+class xe_post{
+private:
+	xe_post* next;
+
+	friend class xe_loop;
+public:
+	void (*callback)(xe_loop& loop, xe_post& post);
+
+	xe_post(){
+		next = null;
+		callback = null;
+	}
+
+	xe_disable_copy_move(xe_post)
+
+	~xe_post() = default;
+};
+
+/*
+ * a callback run once per loop iteration while active, see xe_loop::prepare, check and idle
+ * hooks do not keep the loop alive
+ */
+class xe_hook : protected xe_linked_node{
+private:
+	bool active_: 1;
+
+	friend class xe_loop;
+public:
+	void (*callback)(xe_loop& loop, xe_hook& hook);
+
+	xe_hook(){
+		active_ = false;
+		callback = null;
+	}
+
+	xe_disable_copy_move(xe_hook)
+
+	bool active() const{
+		return active_;
+	}
+
+	~xe_hook() = default;
+};
+
 struct xe_loop_options{
 	uint entries; /* number of sqes */
 	uint cq_entries; /* number of cqes */
 	uint sq_thread_cpu;
 	uint wq_fd;
+	uint max_entries; /* upper bound on sqes when resizing */
+	uint direct_files; /* size of the loop's direct descriptor table, 0 for none */
+	uint fixed_buffers; /* registered buffers in each size class, 0 for none */
+	ulong timer_resolution; /* timer wheel tick in nanoseconds */
+	ulong spin_ns; /* most time to busy poll for completions before blocking, 0 to always block */
+	uint napi_busy_poll_us; /* busy poll the nic queues of the loop's sockets for this long, 0 for none */
 
 	bool flag_sqpoll: 1;
 	bool flag_iopoll: 1;
@@ -134,12 +255,23 @@ struct xe_loop_options{
 
 	/* xe flags */
 	bool flag_iobuf: 1; /* loop allocates a buffer for sync I/O */
+	bool flag_timer_wheel: 1; /* O(1) timers, expire within one timer_resolution tick */
+	bool flag_post: 1; /* accept tasks from other threads */
+	bool flag_adaptive: 1; /* resize the rings at runtime to fit the load, never below entries */
+	bool flag_napi_prefer_busy_poll: 1; /* keep device interrupts off while busy polling */
+	bool flag_tsc_clock: 1; /* read the time from the cpu's invariant tsc where available */
 
 	xe_loop_options(){
 		entries = 0;
 		cq_entries = 0;
 		sq_thread_cpu = 0;
 		wq_fd = 0;
+		max_entries = 0;
+		direct_files = 0;
+		fixed_buffers = 0;
+		timer_resolution = 0;
+		spin_ns = 0;
+		napi_busy_poll_us = 0;
 
 		flag_sqpoll = false;
 		flag_iopoll = false;
@@ -148,6 +280,11 @@ struct xe_loop_options{
 		flag_attach_wq = false;
 
 		flag_iobuf = false;
+		flag_timer_wheel = false;
+		flag_post = false;
+		flag_adaptive = false;
+		flag_napi_prefer_busy_poll = false;
+		flag_tsc_clock = false;
 	}
 
 	~xe_loop_options() = default;
@@ -220,6 +357,10 @@ public:
 		return cqe_flags & IORING_CQE_F_MORE;
 	}
 
+	bool has_buffer() const{
+		return cqe_flags & IORING_CQE_F_BUFFER;
+	}
+
 	ushort buffer_id(){
 		return buffer_id_;
 	}
@@ -227,21 +368,101 @@ public:
 	~xe_promise() = default;
 };
 
+/* holds the timeout until the timed request is submitted */
+class xe_timeout_promise : public xe_promise{
+private:
+	__kernel_timespec ts;
+
+	xe_timeout_promise(){
+		ts.tv_sec = 0;
+		ts.tv_nsec = 0;
+	}
+
+	friend class xe_loop;
+public:
+	xe_timeout_promise(xe_timeout_promise&&) = default;
+
+	~xe_timeout_promise() = default;
+};
+
+/* storage for a linked timeout, must stay alive until the timed request is submitted */
+class xe_deadline{
+private:
+	__kernel_timespec ts;
+	xe_req_info info[2];
+
+	friend class xe_loop;
+public:
+	xe_deadline(){
+		ts.tv_sec = 0;
+		ts.tv_nsec = 0;
+	}
+
+	xe_disable_copy_move(xe_deadline)
+
+	~xe_deadline() = default;
+};
+
 class xe_loop{
 private:
 	io_uring ring;
 
 	ulong active_timers;
 	xe_rbtree<xe_timer> timers;
+	xe_timer_wheel wheel;
+
+	xe_linked_list<xe_hook> prepare_hooks;
+	xe_linked_list<xe_hook> check_hooks;
+	xe_linked_list<xe_hook> idle_hooks;
+	xe_linked_list<xe_hook>::iterator hook_next; /* the next hook to run, moved past a cancelled one */
 
 	xe_ptr io_buf;
 	xe_linked_list<xe_req_info> reqs;
+	xe_frame_pool frames;
+	xe_fixed_buffers fixed;
+
+	std::atomic<xe_post*> posts; /* lifo, reversed when drained */
+	xe_req post_read; /* eventfd wakeups */
+	xe_req post_wake; /* msg_ring wakeups */
+	xe_req_info post_info;
+	ulong post_value;
+	int post_fd;
 
 	ulong handles_;
+	uint passive_; /* handles that don't keep the loop alive */
 	uint queued_;
+	uint direct_files_;
+
+	/* ring resizing */
+	uint min_entries;
+	uint max_entries;
+	uint peak_sq;
+	uint peak_cq;
+	uint window;
+	uint cq_shift;
+
+	/* busy polling */
+	ulong spin_max;
+	ulong arrival_avg; /* moving average of time between completion batches */
+	ulong last_arrival;
+
+	/* time */
+	ulong now_; /* cached once per iteration */
+	ulong calibrated; /* last tsc drift correction */
+
+#ifdef XE_ENABLE_STATS
+	xe_loop_stats stats_;
+	ulong deferred_; /* requests in reqs */
+	ulong stats_mark; /* when the last enter returned */
+#endif
 
 	int error;
 	bool sq_ring_full: 1;
+	bool timer_wheel: 1;
+	bool adaptive: 1;
+	bool tsc: 1;
+	bool post_deferred: 1; /* post_read waits in reqs, not counted as passive yet */
+	bool time_stale: 1; /* now_ predates the last blocking wait */
 
 	int submit(bool);
 
@@ -249,31 +470,106 @@ private:
 	void queue_timer(xe_timer&);
 	void erase_timer(xe_timer&);
 
+	int add_hook(xe_linked_list<xe_hook>&, xe_hook&);
+	void run_hooks(xe_linked_list<xe_hook>&);
+
 	int queue_io(xe_req_info&);
+	int queue_chain(xe_req_info&);
 	int queue_pending();
 
 	int get_sqe(xe_req&, io_uring_sqe*&, xe_req_info* info);
+	int run_chain(xe_chain&);
+
+	bool adapt();
+	bool spin(ulong, ulong&, uint&);
+
+	ulong clock() const{
+		return tsc ? xe_tsc_ns() : xe_time_ns();
+	}
+	int resize(uint, uint); /* requires kernel 6.13 */
+
+	static void post_read_complete(xe_req&, int, uint);
+	static void post_wake_complete(xe_req&, int, uint);
+	static void post_msg_complete(xe_req&, int, uint);
+
+	int arm_post();
+	bool push(xe_post&);
+	int wake();
+	void run_posts();
 public:
 	xe_loop(){
 		active_timers = 0;
 
 		io_buf = null;
 
+		posts = null;
+		post_value = 0;
+		post_fd = -1;
+
 		handles_ = 0;
+		passive_ = 0;
 		queued_ = 0;
+		direct_files_ = 0;
+
+		min_entries = 0;
+		max_entries = 0;
+		peak_sq = 0;
+		peak_cq = 0;
+		window = 0;
+		cq_shift = 0;
+
+		spin_max = 0;
+		arrival_avg = 0;
+		last_arrival = 0;
+
+		now_ = 0;
+		calibrated = 0;
+
+#ifdef XE_ENABLE_STATS
+		deferred_ = 0;
+		stats_mark = 0;
+#endif
 
 		error = 0;
 		sq_ring_full = false;
+		timer_wheel = false;
+		adaptive = false;
+		tsc = false;
+		post_deferred = false;
+		time_stale = false;
 	}
 
 	xe_disable_copy_move(xe_loop)
 
+	friend class xe_chain;
+
 	int init(uint entries);
 	int init_options(xe_loop_options& options);
 	void close();
 
 	int run();
 
+	int fd() const{
+		return ring.ring_fd;
+	}
+
+	/*
+	 * the time in nanoseconds when the current iteration started, relative timers count from here
+	 * same epoch as xe_time_ns, but read from the tsc with flag_tsc_clock
+	 */
+	ulong now() const{
+		return now_;
+	}
+
+	/* refresh now() after a long running callback, never goes backwards */
+	ulong update_time(){
+		ulong time = clock();
+
+		if(time > now_)
+			now_ = time;
+		return now_;
+	}
+
 	xe_inline int run(xe_req& req, xe_op op, xe_req_info* info = null){
 		io_uring_sqe* sqe;
 
@@ -286,6 +582,15 @@ public:
 		return 0;
 	}
 
+	/*
+	 * loop.chain().add(op0, req0).add(op1, req1).submit()
+	 * hard: keep going after a failed request
+	 * a chain deferred for lack of sqes can't be cancelled until it is submitted, cancel returns XE_EBUSY
+	 */
+	xe_chain chain(bool hard = false){
+		return xe_chain(*this, hard);
+	}
+
 	xe_inline int cancel(xe_req& req, xe_req& cancel, xe_op op, xe_req_info* info = null, xe_req_info* cancel_info = null){
 		if(cancel_info && cancel_info -> linked()){
 			/* the request was put in our deferred queue */
@@ -295,9 +600,16 @@ public:
 					cancel_info -> op.sqe.poll32_events = op.sqe.poll32_events;
 				if(op.sqe.len & IORING_POLL_UPDATE_USER_DATA)
 					cancel_info -> op.sqe.user_data = op.sqe.user_data;
+			}else if(cancel_info -> chained){
+				/* the chain is submitted whole, removing one would relink the rest */
+				return XE_EBUSY;
 			}else{
 				/* finish cancel */
 				cancel_info -> erase();
+
+#ifdef XE_ENABLE_STATS
+				deferred_--;
+#endif
 			}
 
 			return 0;
@@ -336,6 +648,16 @@ public:
 		return promise;
 	}
 
+	/*
+	 * run op, cancelling it in the kernel if it doesn't complete within ns nanoseconds
+	 * a timed out request completes with XE_ECANCELED
+	 */
+	int with_timeout(xe_req& req, xe_op op, xe_deadline& deadline, ulong ns);
+	xe_timeout_promise with_timeout(xe_op op, ulong ns);
+
+	/* kernel timeout, completes with XE_ETIME */
+	xe_timeout_promise timeout(ulong ns, uint flags = 0);
+
 	uint sqe_count() const; /* total sqes */
 	uint cqe_count() const; /* total cqes */
 	uint remain() const; /* remaining sqes */
@@ -346,6 +668,22 @@ public:
 
 	int flush(); /* submit any queued sqes */
 
+#ifdef XE_ENABLE_STATS
+	const xe_loop_stats& stats() const{
+		return stats_;
+	}
+#endif
+
+	/*
+	 * hand a task to this loop, safe to call from any thread
+	 * the callback runs on the loop's thread. requires flag_post
+	 * posts made before the loop drains its queue share one wakeup
+	 */
+	int post(xe_post& task);
+
+	/* same as above, but wake with a msg_ring sent from the calling thread's loop */
+	int post(xe_post& task, xe_loop& from);
+
 	int timer_ms(xe_timer& timer, ulong time, ulong repeat, uint flags);
 	int timer_ns(xe_timer& timer, ulong time, ulong repeat, uint flags);
 
@@ -360,6 +698,28 @@ public:
 
 	int cancel(xe_timer& timer);
 
+	/* run the callback every iteration before the loop submits and waits for completions */
+	int prepare(xe_hook& hook);
+
+	/* run the callback every iteration after completions are processed */
+	int check(xe_hook& hook);
+
+	/* run the callback every iteration, and poll instead of blocking while any idle hook is active */
+	int idle(xe_hook& hook);
+
+	/* safe to call from any hook's callback */
+	int cancel(xe_hook& hook);
+
+	/* coroutine frames, see xe_task */
+	xe_frame_pool& frame_pool(){
+		return frames;
+	}
+
+	/* registered buffers, reads and writes on them use the _fixed ops */
+	xe_fixed_buffers& fixed_buffers(){
+		return fixed;
+	}
+
 	/* shared buffer for sync I/O */
 	xe_ptr iobuf() const;
 	xe_ptr iobuf_large() const;
@@ -377,6 +737,20 @@ public:
 	int register_file_alloc_range(uint off, uint len);
 	int unregister_files();
 
+	/*
+	 * with a direct descriptor table, sockets and files opened through the loop
+	 * take a free slot instead of an fd
+	 */
+	uint direct_files() const;
+	int close_direct(uint index);
+
+	/* requires kernel 6.9 */
+	int register_napi(uint busy_poll_us, bool prefer_busy_poll);
+	int unregister_napi();
+
+	int register_buf_ring(io_uring_buf_ring* br, uint entries, ushort bgid);
+	int unregister_buf_ring(ushort bgid);
+
 	~xe_loop() = default;
 
 	static xe_cstr class_name();
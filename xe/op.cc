@@ -507,6 +507,50 @@ xe_op xe_op::epoll_ctl(int epfd, int epop, int fd, epoll_event* events){
 	return op;
 }
 
+xe_op xe_op::timeout(__kernel_timespec* ts, uint count, uint flags){
+	xe_op op;
+
+	xe_sqe_init(op.sqe, IORING_OP_TIMEOUT);
+	xe_sqe_rw_fixed(op.sqe, -1, ts, 1, count, flags, 0);
+
+	op.sqe.splice_fd_in = 0;
+
+	return op;
+}
+
+xe_op xe_op::timeout_update(__kernel_timespec* ts, uint flags){
+	xe_op op;
+
+	xe_sqe_init(op.sqe, IORING_OP_TIMEOUT_REMOVE);
+	xe_sqe_rw_fixed(op.sqe, -1, null, 0, (ulong)ts, flags | IORING_TIMEOUT_UPDATE, 0);
+
+	op.sqe.splice_fd_in = 0;
+
+	return op;
+}
+
+xe_op xe_op::timeout_remove(uint flags){
+	xe_op op;
+
+	xe_sqe_init(op.sqe, IORING_OP_TIMEOUT_REMOVE);
+	xe_sqe_rw_fixed(op.sqe, -1, null, 0, 0, flags, 0);
+
+	op.sqe.splice_fd_in = 0;
+
+	return op;
+}
+
+xe_op xe_op::link_timeout(__kernel_timespec* ts, uint flags){
+	xe_op op;
+
+	xe_sqe_init(op.sqe, IORING_OP_LINK_TIMEOUT);
+	xe_sqe_rw_fixed(op.sqe, -1, ts, 1, 0, flags, 0);
+
+	op.sqe.splice_fd_in = 0;
+
+	return op;
+}
+
 xe_op xe_op::poll_cancel(){
 	xe_op op;
 
@@ -575,6 +619,17 @@ xe_op xe_op::files_update(int* fds, uint len, uint offset){
 	return op;
 }
 
+xe_op xe_op::msg_ring(int fd, uint len, ulong data, uint flags){
+	xe_op op;
+
+	xe_sqe_init(op.sqe, IORING_OP_MSG_RING);
+	xe_sqe_rw_fixed(op.sqe, fd, null, len, data, flags, 0);
+
+	op.sqe.splice_fd_in = 0;
+
+	return op;
+}
+
 xe_op xe_op::provide_buffers(xe_ptr addr, uint len, ushort nr, ushort bgid, ushort bid){
 	xe_op op;
 
@@ -66,6 +66,11 @@ public:
 	static xe_op poll_update		(uint mask, uint flags);
 	static xe_op epoll_ctl			(int epfd, int op, int fd, epoll_event* events);
 
+	static xe_op timeout			(__kernel_timespec* ts, uint count, uint flags);
+	static xe_op timeout_update		(__kernel_timespec* ts, uint flags);
+	static xe_op timeout_remove		(uint flags);
+	static xe_op link_timeout		(__kernel_timespec* ts, uint flags);
+
 	static xe_op poll_cancel		();
 	static xe_op cancel				(uint flags);
 	static xe_op cancel				(int fd, uint flags);
@@ -74,6 +79,8 @@ public:
 
 	static xe_op files_update		(int* fds, uint len, uint offset);
 
+	static xe_op msg_ring			(int fd, uint len, ulong data, uint flags);
+
 	static xe_op provide_buffers	(xe_ptr addr, uint len, ushort nr, ushort bgid, ushort bid);
 	static xe_op remove_buffers		(ushort nr, ushort bgid);
 
@@ -83,6 +90,12 @@ public:
 		return *this;
 	}
 
+	xe_op& orflags(byte flags){
+		sqe.flags |= flags;
+
+		return *this;
+	}
+
 	xe_op& fixed(){
 		return flags(IOSQE_FIXED_FILE);
 	}
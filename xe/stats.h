@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include "xconfig/config.h"
+#include "xstd/types.h"
+#include "xutil/util.h"
+
+enum xe_loop_stats_size{
+	XE_LOOP_STATS_BATCH_BUCKETS = 17 /* the last bucket holds batches of 65536 or more */
+};
+
+/*
+ * loop counters, enabled with XE_ENABLE_STATS
+ * written only by the loop's thread, readable from any thread
+ */
+class xe_loop_stats{
+private:
+	static void add(std::atomic<ulong>& counter, ulong value){
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+	static void peak(std::atomic<ulong>& counter, ulong value){
+		if(value > counter.load(std::memory_order_relaxed))
+			counter.store(value, std::memory_order_relaxed);
+	}
+
+	void enter(ulong submitted){
+		add(enters, 1);
+		add(sqes, submitted);
+		peak(sqes_peak, submitted);
+	}
+
+	void batch(uint cqes_){
+		uint bucket = 31 - __builtin_clz(cqes_);
+
+		add(cqes, cqes_);
+		add(batches[xe_min<uint>(bucket, XE_LOOP_STATS_BATCH_BUCKETS - 1)], 1);
+	}
+
+	void timer(ulong lateness){
+		add(timers, 1);
+		add(timer_lateness, lateness);
+		peak(timer_lateness_peak, lateness);
+	}
+
+	friend class xe_loop;
+public:
+	std::atomic<ulong> enters; /* io_uring_enter calls */
+	std::atomic<ulong> sqes; /* sqes submitted */
+	std::atomic<ulong> sqes_peak; /* most sqes submitted in one enter */
+	std::atomic<ulong> cqes; /* cqes reaped */
+	std::atomic<ulong> batches[XE_LOOP_STATS_BATCH_BUCKETS]; /* cqes reaped at once, bucket n counts batches of 2^n to 2^(n + 1) - 1 */
+
+	std::atomic<ulong> deferred_peak; /* most requests waiting for an sqe */
+	std::atomic<ulong> eagain; /* enter failed for lack of memory */
+	std::atomic<ulong> ebusy; /* enter refused because of cq overflow */
+
+	std::atomic<ulong> timers; /* timers fired */
+	std::atomic<ulong> timer_lateness; /* total ns timers fired after their deadline */
+	std::atomic<ulong> timer_lateness_peak;
+
+	std::atomic<ulong> blocked_ns; /* waiting in the kernel for events */
+	std::atomic<ulong> running_ns; /* everything else */
+
+	xe_loop_stats(){
+		enters = 0;
+		sqes = 0;
+		sqes_peak = 0;
+		cqes = 0;
+
+		for(auto& bucket : batches)
+			bucket = 0;
+		deferred_peak = 0;
+		eagain = 0;
+		ebusy = 0;
+
+		timers = 0;
+		timer_lateness = 0;
+		timer_lateness_peak = 0;
+
+		blocked_ns = 0;
+		running_ns = 0;
+	}
+
+	xe_disable_copy_move(xe_loop_stats)
+
+	~xe_loop_stats() = default;
+};
\ No newline at end of file
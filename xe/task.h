@@ -0,0 +1,226 @@
+#pragma once
+#include <exception>
+#include <type_traits>
+#include "xstd/types.h"
+#include "xstd/optional.h"
+#include "xutil/util.h"
+#include "frame.h"
+#include "loop.h"
+
+#if XE_COROUTINE_EXPERIMENTAL == 1
+namespace xe_coroutine_std = std::experimental;
+#else
+namespace xe_coroutine_std = std;
+#endif
+
+template<typename T = void>
+class xe_task;
+
+class xe_task_promise_base{
+protected:
+	struct xe_final_awaiter{
+		bool await_ready() noexcept{
+			return false;
+		}
+
+		template<class promise_type>
+		xe_coroutine_handle await_suspend(xe_coroutine_std::coroutine_handle<promise_type> handle) noexcept{
+			xe_task_promise_base& promise = handle.promise();
+			xe_coroutine_handle next = promise.continuation;
+
+			/* nobody owns a started task */
+			if(promise.detached)
+				handle.destroy();
+			if(next)
+				return next;
+			return xe_coroutine_std::noop_coroutine();
+		}
+
+		void await_resume() noexcept{}
+	};
+
+	xe_coroutine_handle continuation;
+	bool detached;
+
+	template<typename T>
+	friend class xe_task;
+public:
+	xe_task_promise_base(){
+		continuation = null;
+		detached = false;
+	}
+
+	xe_coroutine_std::suspend_always initial_suspend() noexcept{
+		return {};
+	}
+
+	xe_final_awaiter final_suspend() noexcept{
+		return {};
+	}
+
+	void unhandled_exception(){
+		std::terminate();
+	}
+
+	/*
+	 * frames come from the loop's pool when the coroutine takes the loop as its first argument
+	 * the frame keeps a pointer to the pool, so a task must not outlive its loop
+	 */
+	template<typename... Args>
+	static xe_ptr operator new(size_t size, xe_loop& loop, Args&&...) noexcept{
+		return loop.frame_pool().alloc(size);
+	}
+
+	static xe_ptr operator new(size_t size) noexcept{
+		return xe_frame_pool::alloc_current(size);
+	}
+
+	static void operator delete(xe_ptr ptr){
+		xe_frame_pool::dealloc(ptr);
+	}
+};
+
+template<typename T>
+class xe_task_promise : public xe_task_promise_base{
+private:
+	xe_optional<T> value;
+	bool returned;
+public:
+	xe_task_promise(){
+		returned = false;
+	}
+
+	xe_task<T> get_return_object();
+
+	static xe_task<T> get_return_object_on_allocation_failure(){
+		return xe_task<T>();
+	}
+
+	template<typename U>
+	void return_value(U&& result){
+		xe_construct(&*value, std::forward<U>(result));
+
+		returned = true;
+	}
+
+	T& result(){
+		return *value;
+	}
+
+	~xe_task_promise(){
+		if(returned) value.destruct();
+	}
+};
+
+template<>
+class xe_task_promise<void> : public xe_task_promise_base{
+public:
+	xe_task<void> get_return_object();
+
+	static xe_task<void> get_return_object_on_allocation_failure();
+
+	void return_void(){}
+};
+
+/*
+ * lazily started coroutine
+ * co_await runs it and resumes the awaiter when it returns,
+ * start() runs it detached and frees the frame when it returns
+ */
+template<typename T>
+class xe_task{
+public:
+	typedef xe_task_promise<T> promise_type;
+private:
+	typedef xe_coroutine_std::coroutine_handle<promise_type> handle_type;
+
+	handle_type handle;
+public:
+	xe_task(): handle(){}
+	xe_task(handle_type handle): handle(handle){}
+
+	xe_task(xe_task&& other): handle(other.handle){
+		other.handle = null;
+	}
+
+	xe_task& operator=(xe_task&& other){
+		if(handle) handle.destroy();
+
+		handle = other.handle;
+		other.handle = null;
+
+		return *this;
+	}
+
+	xe_disable_copy(xe_task)
+
+	/* false if the frame could not be allocated */
+	bool valid() const{
+		return handle ? true : false;
+	}
+
+	bool done() const{
+		return !handle || handle.done();
+	}
+
+	/* XE_STATE if there is no coroutine to run: the frame allocation failed, or the task was moved from */
+	int start(){
+		handle_type task = handle;
+
+		if(!task)
+			return XE_STATE;
+		handle = null;
+		task.promise().detached = true;
+		task.resume();
+
+		return 0;
+	}
+
+	/*
+	 * check valid() before awaiting a task whose frame allocation can fail,
+	 * an invalid task asserts, or resumes right away with a default constructed result
+	 */
+	bool await_ready() const{
+		return valid() && handle.done();
+	}
+
+	xe_coroutine_handle await_suspend(xe_coroutine_handle caller){
+		xe_assertm(handle, "awaiting an invalid task");
+
+		if(!handle) [[unlikely]]
+			return caller;
+		handle.promise().continuation = caller;
+
+		return handle;
+	}
+
+	T await_resume(){
+		if constexpr(!std::is_void_v<T>){
+			if(!handle) [[unlikely]] {
+				if constexpr(std::is_default_constructible_v<T>)
+					return T();
+				else
+					std::terminate();
+			}
+
+			return std::move(handle.promise().result());
+		}
+	}
+
+	~xe_task(){
+		if(handle) handle.destroy();
+	}
+};
+
+template<typename T>
+xe_task<T> xe_task_promise<T>::get_return_object(){
+	return xe_task<T>(xe_coroutine_std::coroutine_handle<xe_task_promise<T>>::from_promise(*this));
+}
+
+inline xe_task<void> xe_task_promise<void>::get_return_object(){
+	return xe_task<void>(xe_coroutine_std::coroutine_handle<xe_task_promise<void>>::from_promise(*this));
+}
+
+inline xe_task<void> xe_task_promise<void>::get_return_object_on_allocation_failure(){
+	return xe_task<void>();
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "wheel.h"
+#include "loop.h"
+
+static_assert(sizeof(ulong) * 8 >= 64, "slot bitmap must hold a level");
+
+ulong xe_timer_wheel::expire_tick(const xe_timer& timer) const{
+	/* round up so that a timer never fires early */
+	return timer.expire / resolution + (timer.expire % resolution ? 1 : 0);
+}
+
+void xe_timer_wheel::place(xe_timer& timer, ulong tick){
+	ulong delta;
+	uint level, slot;
+
+	if(tick <= current){
+		timer.slot = SLOT_EXPIRED;
+		expired_.append(timer);
+
+		return;
+	}
+
+	delta = tick - current;
+	level = (63 - xe_clzl(delta)) / LEVEL_BITS;
+
+	if(level >= LEVELS){
+		timer.slot = SLOT_OVERFLOW;
+		overflow.append(timer);
+
+		return;
+	}
+
+	slot = (tick >> (level * LEVEL_BITS)) & LEVEL_MASK;
+	timer.slot = level * LEVEL_SLOTS + slot;
+	occupied[level] |= 1ul << slot;
+	slots[level][slot].append(timer);
+}
+
+void xe_timer_wheel::cascade(uint level){
+	uint slot = (current >> (level * LEVEL_BITS)) & LEVEL_MASK;
+	xe_linked_list<xe_timer>& list = slots[level][slot];
+	xe_timer* timer;
+
+	occupied[level] &= ~(1ul << slot);
+
+	/* everything in this slot is now within range of a lower level */
+	while(list){
+		timer = &list.front();
+		list.erase(*timer);
+
+		place(*timer, expire_tick(*timer));
+	}
+}
+
+void xe_timer_wheel::refill(){
+	xe_timer* timer;
+	ulong due;
+
+	auto it = overflow.begin();
+
+	while(it != overflow.end()){
+		timer = &*(it++);
+		due = expire_tick(*timer);
+
+		if(due - current >= 1ul << (LEVELS * LEVEL_BITS))
+			continue;
+		overflow.erase(*timer);
+
+		place(*timer, due);
+	}
+}
+
+void xe_timer_wheel::init(ulong resolution_, ulong now){
+	resolution = resolution_;
+	current = now / resolution;
+}
+
+void xe_timer_wheel::insert(xe_timer& timer){
+	place(timer, expire_tick(timer));
+}
+
+void xe_timer_wheel::erase(xe_timer& timer){
+	uint level, slot;
+
+	if(timer.slot >= SLOT_EXPIRED){
+		expired_.erase(timer);
+
+		return;
+	}
+
+	level = timer.slot / LEVEL_SLOTS;
+	slot = timer.slot & LEVEL_MASK;
+
+	xe_linked_list<xe_timer>& list = slots[level][slot];
+
+	list.erase(timer);
+
+	if(!list) occupied[level] &= ~(1ul << slot);
+}
+
+void xe_timer_wheel::advance(ulong now){
+	ulong target, next, bits;
+	xe_timer* timer;
+	uint slot, level;
+
+	target = now / resolution;
+
+	while(current < target){
+		slot = (current + 1) & LEVEL_MASK;
+
+		if(slot){
+			/* skip ahead to the next occupied slot or the next cascade */
+			bits = occupied[0] >> slot;
+			next = bits ? current + 1 + xe_ctzl(bits) : (current | LEVEL_MASK) + 1;
+
+			if(next > target){
+				current = target;
+
+				break;
+			}
+
+			current = next;
+		}else{
+			current++;
+		}
+
+		slot = current & LEVEL_MASK;
+
+		if(!slot){
+			for(level = 1; level < LEVELS; level++){
+				cascade(level);
+
+				if((current >> (level * LEVEL_BITS)) & LEVEL_MASK)
+					break;
+			}
+
+			if(level == LEVELS && overflow) [[unlikely]]
+				refill();
+		}
+
+		xe_linked_list<xe_timer>& list = slots[0][slot];
+
+		occupied[0] &= ~(1ul << slot);
+
+		while(list){
+			timer = &list.front();
+			list.erase(*timer);
+			timer -> slot = SLOT_EXPIRED;
+			expired_.append(*timer);
+		}
+	}
+}
+
+ulong xe_timer_wheel::next(ulong now) const{
+	ulong bits, base, tick, due;
+	uint level, shift, rot;
+
+	if(expired_)
+		return 0;
+	tick = xe_max_value<ulong>();
+
+	for(level = 0; level < LEVELS; level++){
+		bits = occupied[level];
+
+		if(!bits)
+			continue;
+		/*
+		 * find the next occupied slot after the current one,
+		 * the current slot itself belongs to the next rotation
+		 */
+		shift = level * LEVEL_BITS;
+		base = current >> shift;
+		rot = (base + 1) & LEVEL_MASK;
+
+		if(rot)
+			bits = (bits >> rot) | (bits << (LEVEL_SLOTS - rot));
+		tick = xe_min(tick, (base + 1 + xe_ctzl(bits)) << shift);
+	}
+
+	if(overflow) [[unlikely]] {
+		shift = LEVELS * LEVEL_BITS;
+		tick = xe_min(tick, ((current >> shift) + 1) << shift);
+	}
+
+	if(tick == xe_max_value<ulong>())
+		return tick;
+	due = tick * resolution;
+
+	return due > now ? due - now : 0;
+}
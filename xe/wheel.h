@@ -0,0 +1,58 @@
+#pragma once
+#include "xstd/types.h"
+#include "xstd/linked_list.h"
+#include "xutil/util.h"
+#include "xutil/mem.h"
+
+class xe_timer;
+class xe_timer_wheel{
+private:
+	enum{
+		LEVEL_BITS = 6,
+		LEVEL_SLOTS = 1 << LEVEL_BITS,
+		LEVEL_MASK = LEVEL_SLOTS - 1,
+		LEVELS = 4,
+
+		SLOT_EXPIRED = LEVELS * LEVEL_SLOTS,
+		SLOT_OVERFLOW
+	};
+
+	ulong expire_tick(const xe_timer&) const;
+	void place(xe_timer&, ulong);
+	void cascade(uint);
+	void refill();
+
+	xe_linked_list<xe_timer> slots[LEVELS][LEVEL_SLOTS];
+	xe_linked_list<xe_timer> overflow; /* deadlines past the last level */
+	xe_linked_list<xe_timer> expired_; /* timers ready to run */
+
+	ulong occupied[LEVELS];
+	ulong current; /* last processed tick */
+	ulong resolution; /* nanoseconds per tick */
+public:
+	xe_timer_wheel(){
+		xe_zero(occupied, LEVELS);
+
+		current = 0;
+		resolution = 0;
+	}
+
+	xe_disable_copy_move(xe_timer_wheel)
+
+	void init(ulong resolution, ulong now);
+
+	void insert(xe_timer& timer);
+	void erase(xe_timer& timer);
+
+	/* move timers due at or before now to the expired list */
+	void advance(ulong now);
+
+	/* nanoseconds until the next timer may be due, or ulong max if none */
+	ulong next(ulong now) const;
+
+	xe_timer* expired(){
+		return expired_ ? &expired_.front() : null;
+	}
+
+	~xe_timer_wheel() = default;
+};
\ No newline at end of file
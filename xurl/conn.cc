@@ -24,35 +24,73 @@ void xe_connection::poll_cb(xe_poll& poll, int res){
 void xe_connection::close_cb(xe_poll& poll){
 	xe_connection& conn = xe_containerof(poll, &xe_connection::poll);
 
-	conn.closed();
+	if(!--conn.polls_closing) conn.closed();
 }
 
-int xe_connection::io(xe_connection& conn, int res){
+void xe_connection::attempt_cb(xe_poll& poll, int res){
+	xe_attempt& attempt = xe_containerof(poll, &xe_attempt::poll);
+	xe_connection& conn = *attempt.conn;
 	socklen_t len = sizeof(res);
 
-	switch(conn.state){
-		case XE_CONNECTION_STATE_CONNECTING:
-			if(getsockopt(conn.fd, SOL_SOCKET, SO_ERROR, &res, &len) < 0)
-				return xe_errno();
-			if(res){
-				res = xe_syserror(res);
+	if(res >= 0){
+		if(getsockopt(attempt.fd, SOL_SOCKET, SO_ERROR, &res, &len) < 0)
+			res = xe_errno();
+		else
+			res = xe_syserror(res);
+	}
 
-				xe_log_debug(&conn, "connection failed, try %zu in %.3f ms, status: %s", conn.ip_index + 1, (xe_time_ns() - conn.time) / (float)XE_NANOS_PER_MS, xe_strerror(res));
+	conn.attempting--;
 
-				if(res != XE_ECONNREFUSED && res != XE_ETIMEDOUT)
-					return res;
-				if(conn.ip_index < xe_max_value(conn.ip_index)){
-					conn.ip_index++;
+	if(!res){
+		/* won the race, the rest are cancelled */
+		conn.fd = attempt.fd;
+		attempt.fd = -1;
+		conn.poll.set_fd(conn.fd);
 
-					return try_connect(conn);
-				}
+		cancel_attempts(conn);
 
-				return res;
-			}
+		if(conn.attempt_timer.active())
+			conn.ctx -> loop().cancel(conn.attempt_timer);
+		res = io(conn, XE_POLL_OUT);
+	}else{
+		xe_log_debug(&conn, "connection failed, try %zu in %.3f ms, status: %s", conn.ip_index, (xe_time_ns() - conn.time) / (float)XE_NANOS_PER_MS, xe_strerror(res));
+
+		::close(attempt.fd);
+
+		attempt.fd = -1;
+		conn.attempt_error = res;
+
+		/* don't wait for the delay, start the next address now */
+		res = try_connect(conn);
+	}
+
+	if(res) conn.close(res);
+}
 
+void xe_connection::attempt_close_cb(xe_poll& poll){
+	xe_connection& conn = *xe_containerof(poll, &xe_attempt::poll).conn;
+
+	if(!--conn.polls_closing && conn.state == XE_CONNECTION_STATE_CLOSED) conn.closed();
+}
+
+int xe_connection::attempt_timeout(xe_loop& loop, xe_timer& timer){
+	xe_connection& conn = xe_containerof(timer, &xe_connection::attempt_timer);
+	int err = try_connect(conn);
+
+	if(!err)
+		return 0;
+	conn.close(err);
+
+	return XE_ECANCELED;
+}
+
+int xe_connection::io(xe_connection& conn, int res){
+	switch(conn.state){
+		case XE_CONNECTION_STATE_CONNECTING:
+			/* reached from attempt_cb once a connect succeeds */
 			conn.endpoint.free();
 
-			xe_log_verbose(&conn, "connected to %.*s:%u after %zu tries in %.3f ms", conn.host.length(), conn.host.data(), xe_ntoh(conn.port), (size_t)conn.ip_index + 1, (xe_time_ns() - conn.time) / (float)XE_NANOS_PER_MS);
+			xe_log_verbose(&conn, "connected to %.*s:%u after %zu tries in %.3f ms", conn.host.length(), conn.host.data(), xe_ntoh(conn.port), conn.ip_index, (xe_time_ns() - conn.time) / (float)XE_NANOS_PER_MS);
 			xe_return_error(conn.init_socket());
 
 			if(conn.ssl_enabled){
@@ -89,6 +127,13 @@ int xe_connection::io(xe_connection& conn, int res){
 
 				if(!conn.readable())
 					xe_return_error(conn.transferctl(XE_PAUSE_SEND));
+				else{
+					/*
+					 * the poll is edge triggered and writable() may stop short of EAGAIN,
+					 * restart it so a socket that is still writable is reported again
+					 */
+					xe_return_error(conn.poll.poll(conn.recv_paused ? XE_POLL_OUT : XE_POLL_IN | XE_POLL_OUT));
+				}
 			}
 
 			if(res & XE_POLL_IN)
@@ -121,7 +166,8 @@ int xe_connection::socket_read(xe_connection& conn){
 	xe_ptr buf = conn.buf;
 	ssize_t result;
 
-	for(uint n = 0; n < 64; n++){
+	/* the poll only reports new data, read until EAGAIN */
+	while(true){
 		if(conn.ssl_enabled)
 			result = conn.ssl.recv(buf, XE_LOOP_IOBUF_SIZE, 0);
 		else{
@@ -148,6 +194,7 @@ int xe_connection::socket_read(xe_connection& conn){
 			break;
 		}
 
+		/* resuming restarts the poll, which reports the data left behind */
 		if(conn.recv_paused) break;
 	}
 
@@ -162,29 +209,6 @@ int xe_connection::timeout(xe_loop& loop, xe_timer& timer){
 	return XE_ECANCELED;
 }
 
-int xe_connection::create_socket(xe_connection& conn, int af){
-	int fd, err;
-
-	if(conn.fd >= 0){
-		::close(conn.fd);
-
-		conn.fd = -1;
-	}
-
-	fd = socket(af, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP);
-
-	if(fd < 0)
-		return xe_errno();
-	conn.poll.set_fd(fd);
-	err = conn.poll.poll(XE_POLL_OUT | XE_POLL_ONESHOT);
-
-	if(err)
-		::close(fd);
-	else
-		conn.fd = fd;
-	return 0;
-}
-
 int xe_connection::ready(xe_connection& conn){
 	uint flags;
 
@@ -215,11 +239,50 @@ int xe_connection::ready(xe_connection& conn){
 	return conn.ssl_enabled ? 0 : conn.poll.poll(XE_POLL_IN);
 }
 
-int xe_connection::try_connect(xe_connection& conn){
-	size_t index = conn.ip_index;
-	uint address_size;
+int xe_connection::next_address(xe_connection& conn, int& family, size_t& index){
+	size_t n = conn.ip_index, first, second, both;
+	int first_family, second_family;
+
+	auto& inet = conn.endpoint -> inet();
+	auto& inet6 = conn.endpoint -> inet6();
+
+	if(conn.ip_mode == XE_IP_ONLY_V6 || conn.ip_mode == XE_IP_PREFER_V6){
+		first_family = AF_INET6;
+		second_family = AF_INET;
+		first = inet6.size();
+		second = conn.ip_mode == XE_IP_ONLY_V6 ? 0 : inet.size();
+	}else{
+		first_family = AF_INET;
+		second_family = AF_INET6;
+		first = inet.size();
+		second = conn.ip_mode == XE_IP_ONLY_V4 ? 0 : inet6.size();
+	}
+
+	/* alternate between the families, then finish the longer list (RFC 8305 section 4) */
+	both = xe_min(first, second);
+
+	if(n < both * 2){
+		family = n & 1 ? second_family : first_family;
+		index = n / 2;
+
+		return 0;
+	}
 
-	int err, family;
+	index = n - both;
+
+	if(index < first)
+		family = first_family;
+	else if(index < second)
+		family = second_family;
+	else
+		return XE_EHOSTUNREACH;
+	return 0;
+}
+
+int xe_connection::start_attempt(xe_connection& conn, xe_attempt& attempt){
+	uint address_size;
+	size_t index;
+	int fd, err, family;
 
 	union{
 		sockaddr addr;
@@ -227,60 +290,112 @@ int xe_connection::try_connect(xe_connection& conn){
 		sockaddr_in6 in6;
 	};
 
-	auto& inet = conn.endpoint -> inet();
-	auto& inet6 = conn.endpoint -> inet6();
-
-	if(conn.ip_mode == XE_IP_ONLY_V6 || conn.ip_mode == XE_IP_PREFER_V6){
-		family = AF_INET6;
-
-		if(index >= inet6.size()){
-			index -= inet6.size();
-
-			if(index >= inet.size() || conn.ip_mode == XE_IP_ONLY_V6)
-				return XE_EHOSTUNREACH;
-			family = AF_INET;
-		}
-	}else{
-		family = AF_INET;
+	xe_return_error(next_address(conn, family, index));
 
-		if(index >= inet.size()){
-			index -= inet.size();
+#ifdef XE_DEBUG
+	if(!conn.ip_index) conn.time = xe_time_ns();
+#endif
 
-			if(index >= inet6.size() || conn.ip_mode == XE_IP_ONLY_V4)
-				return XE_EHOSTUNREACH;
-			family = AF_INET6;
-		}
-	}
+	conn.ip_index++;
 
-	if(index == 0)
-		xe_return_error(create_socket(conn, family));
 	if(family == AF_INET){
 		xe_zero(&in);
-		xe_tmemcpy(&in.sin_addr, &inet[index]);
+		xe_tmemcpy(&in.sin_addr, &conn.endpoint -> inet()[index]);
 
 		in.sin_family = AF_INET;
 		in.sin_port = conn.port;
 		address_size = sizeof(in);
 	}else{
 		xe_zero(&in6);
-		xe_tmemcpy(&in6.sin6_addr, &inet6[index]);
+		xe_tmemcpy(&in6.sin6_addr, &conn.endpoint -> inet6()[index]);
 
 		in6.sin6_family = AF_INET6;
 		in6.sin6_port = conn.port;
 		address_size = sizeof(in6);
 	}
 
-	if(::connect(conn.fd, &addr, address_size) < 0 && (err = xe_errno()) != XE_EINPROGRESS)
-		return err;
-#ifdef XE_DEBUG
-	conn.time = xe_time_ns();
+	fd = socket(family, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP);
+
+	if(fd < 0)
+		return xe_errno();
+	if(::connect(fd, &addr, address_size) < 0 && (err = xe_errno()) != XE_EINPROGRESS)
+		goto fail;
+	attempt.poll.set_fd(fd);
+	err = attempt.poll.poll(XE_POLL_OUT | XE_POLL_ONESHOT);
+
+	if(err)
+		goto fail;
+	attempt.fd = fd;
+	conn.attempting++;
 
+#ifdef XE_DEBUG
 	char ip[INET6_ADDRSTRLEN];
 
-	inet_ntop(family, family == AF_INET ? (xe_ptr)&in.sin_addr : (xe_ptr)&in6.sin6_addr, ip, address_size);
+	inet_ntop(family, family == AF_INET ? (xe_ptr)&in.sin_addr : (xe_ptr)&in6.sin6_addr, ip, sizeof(ip));
 	xe_log_debug(&conn, "connecting to %.*s:%u - trying %s", conn.host.length(), conn.host.data(), xe_ntoh(conn.port), ip);
 #endif
 	return 0;
+fail:
+	::close(fd);
+
+	return err;
+}
+
+void xe_connection::cancel_attempts(xe_connection& conn){
+	for(xe_attempt& attempt : conn.attempts){
+		if(attempt.fd < 0)
+			continue;
+		if(attempt.poll.close()) conn.polls_closing++;
+
+		::close(attempt.fd);
+
+		attempt.fd = -1;
+	}
+
+	conn.attempting = 0;
+}
+
+/*
+ * happy eyeballs (RFC 8305): start the next address whenever an attempt fails,
+ * or when the last one has gone attempt_delay without an answer.
+ * the first to connect wins and the others are cancelled
+ */
+int xe_connection::try_connect(xe_connection& conn){
+	xe_attempt* attempt;
+	int err;
+
+	while(true){
+		attempt = null;
+
+		for(xe_attempt& slot : conn.attempts){
+			if(slot.fd >= 0)
+				continue;
+			attempt = &slot;
+
+			break;
+		}
+
+		/* every slot is racing, the next failure makes room */
+		if(!attempt)
+			return 0;
+		err = start_attempt(conn, *attempt);
+
+		if(!err)
+			break;
+		if(err == XE_EHOSTUNREACH){
+			/* out of addresses, wait for the ones still racing */
+			if(conn.attempting)
+				return 0;
+			return conn.attempt_error ? conn.attempt_error : err;
+		}
+
+		/* this address failed right away, move on */
+		conn.attempt_error = err;
+	}
+
+	if(conn.attempt_timer.active())
+		conn.ctx -> loop().cancel(conn.attempt_timer);
+	return conn.ctx -> loop().timer_ms(conn.attempt_timer, conn.attempt_delay, 0, 0);
 }
 
 int xe_connection::set_nodelay(bool nodelay){
@@ -347,6 +462,9 @@ int xe_connection::init(xurl_ctx& ctx_){
 	buf = ctx_.loop().iobuf();
 	poll.set_loop(ctx_.loop());
 
+	for(xe_attempt& attempt : attempts)
+		attempt.poll.set_loop(ctx_.loop());
+
 	if(buf)
 		return 0;
 	buf = xe_alloc_aligned<byte>(0, XE_LOOP_IOBUF_SIZE);
@@ -362,6 +480,10 @@ void xe_connection::set_ip_mode(xe_ip_mode mode){
 	ip_mode = mode;
 }
 
+void xe_connection::set_attempt_delay(uint delay_ms){
+	attempt_delay = delay_ms;
+}
+
 int xe_connection::init_ssl(const xe_ssl_ctx& shared){
 	int err = ssl.init(shared);
 
@@ -480,19 +602,21 @@ void xe_connection::close(int error){
 
 	if(timer.active())
 		xe_assertz(stop_timer());
-	error = 0;
-
+	if(attempt_timer.active())
+		ctx -> loop().cancel(attempt_timer);
 	if(prev_state != XE_CONNECTION_STATE_IDLE){
 		ctx -> closing(*this);
 
 		if(prev_state > XE_CONNECTION_STATE_RESOLVING){
 			if(prev_state != XE_CONNECTION_STATE_ACTIVE || !recv_paused || !send_paused)
 				ctx -> active--;
-			error = poll.close();
+			cancel_attempts(*this);
+
+			if(poll.close()) polls_closing++;
 		}
 	}
 
-	if(!error) closed();
+	if(!polls_closing) closed();
 }
 
 xe_connection::~xe_connection(){
@@ -502,6 +626,9 @@ xe_connection::~xe_connection(){
 		ssl.close();
 	if(fd >= 0)
 		::close(fd);
+	for(xe_attempt& attempt : attempts){
+		if(attempt.fd >= 0) ::close(attempt.fd);
+	}
 }
 
 xe_cstr xe_connection::class_name(){
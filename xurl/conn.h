@@ -16,13 +16,29 @@ enum xe_connection_state{
 	XE_CONNECTION_STATE_CLOSED
 };
 
+enum xe_connection_attempts{
+	XE_CONNECTION_MAX_ATTEMPTS = 4, /* connects racing at once, later addresses wait for a slot */
+	XE_CONNECTION_ATTEMPT_DELAY = 250 /* ms before racing the next address, from RFC 8305 */
+};
+
 class xe_connection : protected xe_linked_node{
 private:
+	struct xe_attempt{
+		xe_connection* conn;
+		xe_poll poll;
+		int fd;
+	};
+
 	static void poll_cb(xe_poll&, int);
 	static void close_cb(xe_poll&);
+	static void attempt_cb(xe_poll&, int);
+	static void attempt_close_cb(xe_poll&);
+	static int attempt_timeout(xe_loop&, xe_timer&);
 
 	static int io(xe_connection&, int);
-	static int create_socket(xe_connection&, int);
+	static int next_address(xe_connection&, int&, size_t&);
+	static int start_attempt(xe_connection&, xe_attempt&);
+	static void cancel_attempts(xe_connection&);
 	static int try_connect(xe_connection&);
 	static int ready(xe_connection&);
 	static int socket_read(xe_connection&);
@@ -41,9 +57,17 @@ private:
 	xe_ssl ssl;
 
 	xe_shared_ref<xe_endpoint> endpoint;
-	size_t ip_index;
+	size_t ip_index; /* addresses tried */
 	xe_ip_mode ip_mode;
 
+	/* happy eyeballs, see try_connect */
+	xe_attempt attempts[XE_CONNECTION_MAX_ATTEMPTS];
+	xe_timer attempt_timer;
+	uint attempt_delay;
+	uint attempting;
+	uint polls_closing;
+	int attempt_error; /* from the last failed attempt */
+
 	int fd;
 
 	ushort port;
@@ -79,9 +103,23 @@ public:
 	xe_connection(){
 		poll.poll_callback = poll_cb;
 		poll.close_callback = close_cb;
+		poll.set_multishot(true);
+
+		for(xe_attempt& attempt : attempts){
+			attempt.conn = this;
+			attempt.poll.poll_callback = attempt_cb;
+			attempt.poll.close_callback = attempt_close_cb;
+			attempt.fd = -1;
+		}
+
+		attempt_timer.callback = attempt_timeout;
 
 		ip_index = 0;
 		ip_mode = XE_IP_ANY;
+		attempt_delay = XE_CONNECTION_ATTEMPT_DELAY;
+		attempting = 0;
+		polls_closing = 0;
+		attempt_error = 0;
 
 		ssl_enabled = false;
 		ssl_verify = false;
@@ -99,6 +137,9 @@ public:
 	void set_ip_mode(xe_ip_mode mode);
 	void set_ssl_verify(bool verify);
 
+	/* how long a connect may go unanswered before the next address joins the race */
+	void set_attempt_delay(uint delay_ms);
+
 	int connect(const xe_string_view& host, ushort port, uint timeout_ms = 0);
 
 	int transferctl(uint flags);
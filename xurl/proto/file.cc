@@ -1,6 +1,6 @@
 #include "file.h"
 #include "xe/error.h"
-#include "xe/io/file.h"
+#include "xe/io/reader.h"
 #include "xutil/log.h"
 #include "../url.h"
 #include "../ctx.h"
@@ -10,7 +10,8 @@
 namespace xurl{
 
 enum{
-	XE_FILE_STREAM_BUFFER_SIZE = XE_LOOP_IOBUF_SIZE
+	XE_FILE_STREAM_DEPTH = 4,
+	XE_FILE_STREAM_CHUNK_SIZE = XE_LOOP_IOBUF_SIZE_LARGE
 };
 
 class xe_file_stream;
@@ -26,70 +27,43 @@ public:
 
 class xe_file_stream{
 public:
-	xe_file file;
+	xe_file_reader reader;
 	xe_file_data* data;
 	xe_request_internal* request;
 
 	xe_string path;
-	xe_open_req open;
-	xe_req read;
-	long offset;
+	bool started;
 
-	byte* buf;
+	static void read_callback(xe_file_reader& reader, int result, xe_ptr buf){
+		xe_file_stream& stream = xe_containerof(reader, &xe_file_stream::reader);
 
-	static void open_callback(xe_open_req& req, int result){
-		xe_file_stream& stream = xe_containerof(req, &xe_file_stream::open);
-
-		if(!result)
-			result = stream.file.read(stream.read, stream.buf, XE_FILE_STREAM_BUFFER_SIZE, stream.offset);
-		if(result)
-			stream.complete(result);
-		else
+		if(!stream.started){
+			stream.started = true;
 			stream.request -> set_state(XE_REQUEST_STATE_ACTIVE);
-	}
-
-	static void read_callback(xe_req& req, int result){
-		xe_file_stream& stream = xe_containerof(req, &xe_file_stream::read);
-
-		do{
-			if(result <= 0)
-				break;
-			if(stream.request -> write(stream.buf, result)){
-				result = XE_ECANCELED;
-
-				break;
-			}
-
-			stream.offset += result;
-			result = stream.file.read(stream.read, stream.buf, XE_FILE_STREAM_BUFFER_SIZE, stream.offset);
+		}
 
-			if(result)
-				break;
-			return;
-		}while(false);
-
-		stream.complete(result);
+		if(result <= 0)
+			stream.complete(result);
+		else if(stream.request -> write(buf, result))
+			reader.stop();
 	}
 
-	xe_file_stream(xe_loop& loop, xe_request_internal* request_){
-		file.set_loop(loop);
+	xe_file_stream(xe_loop& loop, xe_request_internal* request_): reader(loop){
 		request = request_;
 		data = (xe_file_data*)request -> data;
+		started = false;
 
-		open.callback = open_callback;
-		read.callback = read_callback;
+		reader.callback = read_callback;
 	}
 
 	int start(){
 		int err;
 
-		buf = xe_alloc<byte>(XE_FILE_STREAM_BUFFER_SIZE);
-
-		if(!buf)
-			return XE_ENOMEM;
 		if(!path.copy(data -> url.path()))
 			return XE_ENOMEM;
-		err = file.open(open, path.c_str(), O_RDONLY);
+		xe_return_error(reader.init(XE_FILE_STREAM_DEPTH, XE_FILE_STREAM_CHUNK_SIZE));
+
+		err = reader.open(path.c_str());
 
 		if(!err)
 			request -> set_state(XE_REQUEST_STATE_CONNECTING);
@@ -104,9 +78,7 @@ public:
 		request -> complete(res);
 	}
 
-	~xe_file_stream(){
-		xe_dealloc(buf);
-	}
+	~xe_file_stream() = default;
 };
 
 class xe_file_protocol : public xe_protocol{
@@ -1,6 +1,7 @@
 #pragma once
 #include "xstd/types.h"
 #include "../ssl.h"
+#include "../conn.h"
 #include "../protocol.h"
 
 namespace xurl{
@@ -9,6 +10,7 @@ class xe_net_common_data : public xe_protocol_specific{
 protected:
 	uint connect_timeout;
 	uint recvbuf_size;
+	uint attempt_delay;
 	ushort port;
 	xe_ip_mode ip_mode;
 	const xe_ssl_ctx* ssl_ctx;
@@ -18,6 +20,7 @@ protected:
 	xe_net_common_data(xe_protocol_id id): xe_protocol_specific(id){
 		connect_timeout = 0;
 		recvbuf_size = 0;
+		attempt_delay = XE_CONNECTION_ATTEMPT_DELAY;
 		port = 0;
 		ip_mode = XE_IP_ANY;
 		ssl_ctx = null;
@@ -56,6 +59,14 @@ public:
 		return ip_mode;
 	}
 
+	void set_attempt_delay(uint attempt_delay_){
+		attempt_delay = attempt_delay_;
+	}
+
+	uint get_attempt_delay() const{
+		return attempt_delay;
+	}
+
 	void set_ssl_ctx(const xe_ssl_ctx& ssl_ctx_){
 		ssl_ctx = &ssl_ctx_;
 	}
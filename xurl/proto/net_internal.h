@@ -13,6 +13,7 @@ static int xe_start_connection(
 
 	conn.set_ssl_verify(data.get_ssl_verify());
 	conn.set_ip_mode(data.get_ip_mode());
+	conn.set_attempt_delay(data.get_attempt_delay());
 
 	if(secure)
 		xe_return_error(conn.init_ssl(data.get_ssl_ctx()));
@@ -39,6 +39,10 @@ void xe_request::set_ip_mode(xe_ip_mode mode){
 	((xe_net_common_data*)data) -> set_ip_mode(mode);
 }
 
+void xe_request::set_attempt_delay(uint delay_ms){
+	((xe_net_common_data*)data) -> set_attempt_delay(delay_ms);
+}
+
 void xe_request::set_recvbuf_size(uint size){
 	((xe_net_common_data*)data) -> set_recvbuf_size(size);
 }
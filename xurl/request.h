@@ -60,6 +60,7 @@ public:
 	void set_ssl_ctx(const xe_ssl_ctx& ctx);
 	void set_ssl_verify(bool verify);
 	void set_ip_mode(xe_ip_mode mode);
+	void set_attempt_delay(uint delay_ms);
 	void set_recvbuf_size(uint size);
 
 	void set_max_redirects(uint max_redirects);